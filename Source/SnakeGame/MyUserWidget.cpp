@@ -2,55 +2,168 @@
 #include "Components/TextBlock.h"
 #include "Engine/Engine.h" 
 
-void UMyUserWidget::SetScore(int32 InScore)
+void FSnakeHudModel::SetScore(int32 InScore)
 {
-	if (!IsValid(this) || !ScoreText)
+	if (Score != InScore)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UMyUserWidget::SetScore called but ScoreText is invalid."));
-		return;
+		Score = InScore;
+		Dirty |= DirtyScore;
 	}
-	ScoreText->SetText(FText::AsNumber(InScore));
 }
 
-void UMyUserWidget::SetLevel(int32 InLevel)
+void FSnakeHudModel::SetLevel(int32 InLevel)
+{
+	if (Level != InLevel)
+	{
+		Level = InLevel;
+		Dirty |= DirtyLevel;
+	}
+}
+
+void FSnakeHudModel::SetPlayerScore(int32 PlayerIndex, int32 InScore)
 {
-	if (!IsValid(this) || !LevelText)
+	if (PlayerIndex < 0)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UMyUserWidget::SetLevel called but LevelText is invalid."));
 		return;
 	}
-	LevelText->SetText(FText::AsNumber(InLevel));
+	while (PlayerScores.Num() <= PlayerIndex)
+	{
+		PlayerScores.Add(INDEX_NONE);
+		DirtyPlayerScores.Add(false);
+	}
+
+	if (PlayerScores[PlayerIndex] != InScore)
+	{
+		PlayerScores[PlayerIndex] = InScore;
+		DirtyPlayerScores[PlayerIndex] = true;
+		Dirty |= DirtyPlayers;
+	}
 }
 
-void UMyUserWidget::SetPlayerScores(int32 InP1Score, int32 InP2Score)
+void FSnakeHudModel::ClearDirty()
+{
+	Dirty = DirtyNone;
+	DirtyPlayerScores.SetRange(0, DirtyPlayerScores.Num(), false);
+}
+
+void UMyUserWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	PlayerScoreTexts.Reset();
+	PlayerScoreTexts.Add(ScoreP1Text);
+	PlayerScoreTexts.Add(ScoreP2Text);
+
+	// Widgets for more players only need to follow the naming, nothing else to bind
+	for (int32 Player = 3; ; ++Player)
+	{
+		UTextBlock* Text = Cast<UTextBlock>(GetWidgetFromName(*FString::Printf(TEXT("ScoreP%dText"), Player)));
+		if (!Text)
+		{
+			break;
+		}
+		PlayerScoreTexts.Add(Text);
+	}
+}
+
+void UMyUserWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	// Values set before the widget was shown
+	FlushModel();
+}
+
+void UMyUserWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	FlushModel();
+}
+
+void UMyUserWidget::FlushModel()
 {
-	if (!IsValid(this))
+	if (Model.Dirty == FSnakeHudModel::DirtyNone)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UMyUserWidget::SetPlayerScores called but widget is invalid."));
 		return;
 	}
 
-	if (ScoreP1Text)
+	if ((Model.Dirty & FSnakeHudModel::DirtyScore) && ScoreText)
 	{
-		ScoreP1Text->SetText(
-			FText::Format(NSLOCTEXT("UI","P1Score","P1: {0}"),
-						  FText::AsNumber(InP1Score))
-		);
+		ScoreText->SetText(FText::AsNumber(Model.Score));
 	}
-	else
+
+	if ((Model.Dirty & FSnakeHudModel::DirtyLevel) && LevelText)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UMyUserWidget::SetPlayerScores: ScoreP1Text is null!"));
+		LevelText->SetText(FText::AsNumber(Model.Level));
 	}
 
-	if (ScoreP2Text)
+	if (Model.Dirty & FSnakeHudModel::DirtyPlayers)
 	{
-		ScoreP2Text->SetText(
-			FText::Format(NSLOCTEXT("UI","P2Score","P2: {0}"),
-						  FText::AsNumber(InP2Score))
-		);
+		// Parsed once instead of on every score change. P1 and P2 keep their shipped keys;
+		// only players past the second use the numbered format.
+		static const FTextFormat P1ScoreFormat(NSLOCTEXT("UI","P1Score","P1: {0}"));
+		static const FTextFormat P2ScoreFormat(NSLOCTEXT("UI","P2Score","P2: {0}"));
+		static const FTextFormat PlayerScoreFormat(NSLOCTEXT("UI", "PlayerScore", "P{0}: {1}"));
+
+		for (TConstSetBitIterator<> It(Model.DirtyPlayerScores); It; ++It)
+		{
+			const int32 Player = It.GetIndex();
+			if (!PlayerScoreTexts.IsValidIndex(Player) || !PlayerScoreTexts[Player])
+			{
+				continue;
+			}
+
+			const FText Score = FText::AsNumber(Model.PlayerScores[Player]);
+			if (Player < 2)
+			{
+				PlayerScoreTexts[Player]->SetText(FText::Format(Player == 0 ? P1ScoreFormat : P2ScoreFormat, Score));
+			}
+			else
+			{
+				PlayerScoreTexts[Player]->SetText(FText::Format(PlayerScoreFormat, FText::AsNumber(Player + 1), Score));
+			}
+		}
 	}
-	else
+
+	Model.ClearDirty();
+}
+
+void UMyUserWidget::SetScore(int32 InScore)
+{
+	Model.SetScore(InScore);
+}
+
+void UMyUserWidget::SetLevel(int32 InLevel)
+{
+	Model.SetLevel(InLevel);
+}
+
+void UMyUserWidget::SetPlayerScores(int32 InP1Score, int32 InP2Score)
+{
+	Model.SetPlayerScore(0, InP1Score);
+	Model.SetPlayerScore(1, InP2Score);
+}
+
+void UMyUserWidget::SetPlayerScore(int32 PlayerIndex, int32 InScore)
+{
+	Model.SetPlayerScore(PlayerIndex, InScore);
+}
+
+void UMyUserWidget::ApplyScoreLayout(bool bPerPlayerScores)
+{
+	const ESlateVisibility Shared = bPerPlayerScores ? ESlateVisibility::Collapsed : ESlateVisibility::Visible;
+	const ESlateVisibility PerPlayer = bPerPlayerScores ? ESlateVisibility::Visible : ESlateVisibility::Collapsed;
+
+	if (ScoreText)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UMyUserWidget::SetPlayerScores: ScoreP2Text is null!"));
+		ScoreText->SetVisibility(Shared);
 	}
-}
\ No newline at end of file
+	for (UTextBlock* PlayerText : PlayerScoreTexts)
+	{
+		if (PlayerText)
+		{
+			PlayerText->SetVisibility(PerPlayer);
+		}
+	}
+}
@@ -5,6 +5,35 @@
 #include "Components/TextBlock.h"
 #include "MyUserWidget.generated.h"
 
+/**
+ * Values shown by the HUD and which of them changed since they were last pushed to the text
+ * blocks. Setting a value only stores it, so any number of updates in a frame cost one flush.
+ */
+struct FSnakeHudModel
+{
+	enum EDirtyFlags : uint8
+	{
+		DirtyNone    = 0,
+		DirtyScore   = 1 << 0,
+		DirtyLevel   = 1 << 1,
+		DirtyPlayers = 1 << 2
+	};
+
+	// INDEX_NONE until first set, so the first value always reaches the widget
+	int32 Score = INDEX_NONE;
+	int32 Level = INDEX_NONE;
+	TArray<int32> PlayerScores;
+
+	uint8 Dirty = DirtyNone;
+	TBitArray<> DirtyPlayerScores;
+
+	void SetScore(int32 InScore);
+	void SetLevel(int32 InLevel);
+	void SetPlayerScore(int32 PlayerIndex, int32 InScore);
+
+	void ClearDirty();
+};
+
 UCLASS()
 class SNAKEGAME_API UMyUserWidget : public UUserWidget
 {
@@ -31,4 +60,26 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category="UI")
 	void SetPlayerScores(int32 InP1Score, int32 InP2Score);
-};
\ No newline at end of file
+
+	/** Score of one player, 0 based; shown in ScoreP<N>Text when the widget has one. */
+	UFUNCTION(BlueprintCallable, Category="UI")
+	void SetPlayerScore(int32 PlayerIndex, int32 InScore);
+
+	/** Shows either the shared score or the per-player scores; only changes with the game type. */
+	UFUNCTION(BlueprintCallable, Category="UI")
+	void ApplyScoreLayout(bool bPerPlayerScores);
+
+protected:
+	virtual void NativeOnInitialized() override;
+	virtual void NativeConstruct() override;
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+	/** Writes the changed model values to the text blocks. */
+	void FlushModel();
+
+	FSnakeHudModel Model;
+
+	// ScoreP1Text, ScoreP2Text and any further ScoreP<N>Text found in the widget tree
+	UPROPERTY()
+	TArray<UTextBlock*> PlayerScoreTexts;
+};
@@ -1,66 +1,117 @@
 #include "SnakeAIController.h"
 
-#include <queue>
-
+#include "SnakeAIManagerSubsystem.h"
 #include "SnakePawn.h"
 #include "SnakeWorld.h"
-#include "SnakeFood.h"
 #include "Definitions.h"
-#include "Kismet/GameplayStatics.h"
 #include "DrawDebugHelpers.h"
-#include "SnakeTailSegment.h"
+#include "HAL/IConsoleManager.h"
+
+#if ENABLE_DRAW_DEBUG
+static TAutoConsoleVariable<bool> CVarSnakeAIDrawPaths(
+    TEXT("snake.AI.DrawPaths"),
+    false,
+    TEXT("Draws the goal and planned path of each AI snake whenever it decides a move."));
+#endif
 
 ASnakeAIController::ASnakeAIController()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Decisions are made in batches by USnakeAIManagerSubsystem
+    PrimaryActorTick.bCanEverTick = false;
 }
 
-void ASnakeAIController::Tick(float DeltaTime)
+void ASnakeAIController::BeginPlay()
 {
-    Super::Tick(DeltaTime);
+    Super::BeginPlay();
 
-    ASnakePawn* Snake = Cast<ASnakePawn>(GetPawn());
-    if (!Snake) return;
+    if (USnakeAIManagerSubsystem* Manager = GetWorld()->GetSubsystem<USnakeAIManagerSubsystem>())
+    {
+        Manager->RegisterController(this);
+    }
+}
+
+void ASnakeAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (USnakeAIManagerSubsystem* Manager = GetWorld()->GetSubsystem<USnakeAIManagerSubsystem>())
+    {
+        Manager->UnregisterController(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+bool ASnakeAIController::ConsumeNewTile(const ASnakeWorld& World, FIntPoint& OutHead)
+{
+    const ASnakePawn* Snake = Cast<ASnakePawn>(GetPawn());
+    if (!Snake) return false;
 
     // Only recalc when we've actually moved into a new tile
     if (Snake->LastTilePosition.Equals(PrevTilePosition, 1e-3f))
-        return;
+        return false;
     PrevTilePosition = Snake->LastTilePosition;
 
-    // Find & snap the closest apple
-    TArray<AActor*> Foods;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ASnakeFood::StaticClass(), Foods);
-    if (Foods.Num() == 0) return;
+    OutHead = World.WorldToCell(PrevTilePosition);
+    return true;
+}
 
-    AActor* Closest = Foods[0];
-    float Best = FVector::Dist(PrevTilePosition, Closest->GetActorLocation());
-    for (AActor* F : Foods)
+ESnakeDirection ASnakeAIController::DecideDirection(const FSnakeSimulation& Sim, const FSnakeDistanceField& Field, const ASnakePawn& Snake, const FIntPoint& Head)
+{
+    // Closest apple by walking distance, read from the field every AI snake shares
+    DebugGoal = FIntPoint::NoneValue;
+    if (!Field.IsReachable(Head))
+        return ESnakeDirection::None;
+    const FIntPoint Goal = Field.GetNearestSource(Head);
+    DebugGoal = Goal;
+
+    ESnakeDirection Dir = ESnakeDirection::None;
+    switch (PathMode)
     {
-        float D = FVector::Dist(PrevTilePosition, F->GetActorLocation());
-        if (D < Best) { Best = D; Closest = F; }
+        case ESnakeAIPathMode::DistanceField:
+            Dir = FollowDistanceField(Sim, Field, Head, Snake.Direction);
+            break;
+        case ESnakeAIPathMode::AStar:
+        case ESnakeAIPathMode::JumpPoint:
+            Dir = FollowPath(Sim, Head, Goal, Snake.Direction);
+            break;
     }
-    FVector Goal = SnapToGrid(Closest->GetActorLocation());
 
-    // Run BFS
-    TArray<FVector> Path;
-    if (!FindPath(PrevTilePosition, Goal, Path) || Path.Num() < 2)
-        return;
+    // Only take the greedy move if it leaves a way back to our own tail
+    if (PlannerBudgetMicroseconds > 0)
+    {
+        Dir = SurvivalPlanner.ChooseDirection(Sim, Snake.SnakeId, Goal, Dir, Snake.Direction, PlannerBudgetMicroseconds);
+    }
+    return Dir;
+}
 
-    // Debug draw
-    for (int32 i = 0; i < Path.Num(); ++i)
+void ASnakeAIController::ApplyDirection(const ASnakeWorld& World, ESnakeDirection Dir)
+{
+    ASnakePawn* Snake = Cast<ASnakePawn>(GetPawn());
+    if (!Snake) return;
+
+#if ENABLE_DRAW_DEBUG
+    // Debug draw, opt in since decisions run at the simulation step rate
+    if (CVarSnakeAIDrawPaths.GetValueOnGameThread())
     {
-        DrawDebugSphere(GetWorld(), Path[i], TileSize * 0.2f, 8, FColor::Yellow, false, 0.1f);
-        if (i < Path.Num() - 1)
-            DrawDebugLine(GetWorld(), Path[i], Path[i+1], FColor::Blue, false, 0.1f, 0, 5.f);
+        if (PathMode == ESnakeAIPathMode::DistanceField || Path.Num() < 2)
+        {
+            if (DebugGoal != FIntPoint::NoneValue)
+                DrawDebugSphere(GetWorld(), World.CellToWorld(DebugGoal), TileSize * 0.2f, 8, FColor::Yellow, false, 0.1f);
+        }
+        else
+        {
+            for (int32 i = PathIndex; i < Path.Num(); ++i)
+            {
+                const FVector Point = World.CellToWorld(Path[i]);
+                DrawDebugSphere(GetWorld(), Point, TileSize * 0.2f, 8, FColor::Yellow, false, 0.1f);
+                if (i < Path.Num() - 1)
+                    DrawDebugLine(GetWorld(), Point, World.CellToWorld(Path[i+1]), FColor::Blue, false, 0.1f, 0, 5.f);
+            }
+        }
     }
+#endif
 
-    // Next step delta
-    FVector Delta = Path[1] - PrevTilePosition;
-    ESnakeDirection Dir = ESnakeDirection::None;
-    if (FMath::Abs(Delta.X) > FMath::Abs(Delta.Y))
-        Dir = (Delta.X > 0) ? ESnakeDirection::Up : ESnakeDirection::Down;
-    else
-        Dir = (Delta.Y > 0) ? ESnakeDirection::Right : ESnakeDirection::Left;
+    if (Dir == ESnakeDirection::None)
+        return;
 
     // NO U-turn: only skip the *set* if it’s opposite, but do NOT abort the rest of the tick
     auto IsOpposite = [](ESnakeDirection A, ESnakeDirection B){
@@ -99,99 +150,171 @@ void ASnakeAIController::Tick(float DeltaTime)
     }
 }
 
-FVector ASnakeAIController::SnapToGrid(const FVector& WorldPos)
+void ASnakeAIController::ResetPlan()
 {
-    return ::SnapToGrid(WorldPos);
+    // An in-flight query is left to finish, it shares AsyncPathfinder with the next one; its
+    // result is only adopted if it happens to start on the new head cell
+    ClearPath();
+    DebugGoal = FIntPoint::NoneValue;
+    PrevTilePosition = FVector(FLT_MAX);
 }
 
-bool ASnakeAIController::FindPath(
-    const FVector& Start,
-    const FVector& Goal,
-    TArray<FVector>& OutPath
-) const
+ESnakeDirection ASnakeAIController::FollowDistanceField(const FSnakeSimulation& Sim, const FSnakeDistanceField& Field, const FIntPoint& Head, ESnakeDirection Current)
 {
-    // Get the world and its walkable tiles
-    ASnakeWorld* World = Cast<ASnakeWorld>(
-        UGameplayStatics::GetActorOfClass(GetWorld(), ASnakeWorld::StaticClass())
-    );
-    if (!World) return false;
-
-    TSet<FVector> Walkable(World->FloorTileLocations);
-
-    // Exclude tiles occupied by the snake’s tail
-    TSet<FVector> BodyTiles;
-    if (ASnakePawn* SnakePawn = Cast<ASnakePawn>(GetPawn()))
-    {
-        auto SnapGrid = [&](const FVector& V){
-            return FVector(
-                FMath::RoundToFloat(V.X / TileSize) * TileSize,
-                FMath::RoundToFloat(V.Y / TileSize) * TileSize,
-                V.Z
-            );
-        };
-        for (ASnakeTailSegment* Segment : SnakePawn->TailSegments)
-        {
-            BodyTiles.Add(SnapGrid(Segment->GetActorLocation()));
-        }
-        BodyTiles.Remove(Start);
-    }
-    auto Snap = [&](const FVector& V){
-        return FVector(
-            FMath::RoundToFloat(V.X / TileSize) * TileSize,
-            FMath::RoundToFloat(V.Y / TileSize) * TileSize,
-            V.Z
-        );
-    };
-    FVector S = Snap(Start), G = Snap(Goal);
-    if (!Walkable.Contains(G)) return false;
-
-    // BFS setup
-    std::queue<FVector> Q;
-    Q.push(S);
-    TMap<FVector, FVector> CameFrom;
-    CameFrom.Add(S, S);
-
-    static const TArray<FVector> Directions = {
-        FVector(TileSize, 0, 0),
-        FVector(-TileSize, 0, 0),
-        FVector(0, TileSize, 0),
-        FVector(0, -TileSize, 0)
-    };
+    // Downhill on the field; a body in the way only costs the step it blocks, so the snake
+    // takes the best free neighbour even when that one leads uphill
+    return ChooseStep(Sim, Head, Current, [&Field](const FIntPoint& Cell) { return Field.GetDistance(Cell); });
+}
+
+ESnakeDirection ASnakeAIController::FollowPath(const FSnakeSimulation& Sim, const FIntPoint& Head, const FIntPoint& Goal, ESnakeDirection Current)
+{
+    // A finished search was planned from the cell we predicted last tile, take it if we got there
+    AdoptPathQuery(Head, Goal);
+
+    // Follow the cached path. When it no longer leads to the goal, search on a worker and keep
+    // moving with a safe step until the result lands on a later tile boundary
+    ESnakeDirection Dir = ESnakeDirection::None;
+    if (UpdatePath(Sim, Head, Goal))
+    {
+        // Next step direction
+        Dir = FSnakeSimulation::GetDirectionBetween(Path[PathIndex], Path[PathIndex + 1]);
+    }
+    else
+    {
+        Dir = ChooseSafeDirection(Sim, Head, Goal, Current);
+        const ESnakeDirection NextDir = Dir != ESnakeDirection::None ? Dir : Current;
+        LaunchPathQuery(Sim, Head + FSnakeSimulation::GetDirectionOffset(NextDir), Goal);
+    }
+    return Dir;
+}
 
-    // BFS loop, skips any body‐occupied tile
-    while (!Q.empty())
+bool ASnakeAIController::UpdatePath(const FSnakeSimulation& Sim, const FIntPoint& Head, const FIntPoint& Goal)
+{
+    if (Goal != PathGoal)
     {
-        FVector Curr = Q.front(); Q.pop();
-        if (Curr == G) break;
+        ClearPath();
+        return false;
+    }
 
-        for (const FVector& Dir : Directions)
+    // Moved one step along the plan, or somewhere the plan did not expect
+    if (Path.IsValidIndex(PathIndex + 1) && Path[PathIndex + 1] == Head)
+    {
+        ++PathIndex;
+    }
+    else if (!Path.IsValidIndex(PathIndex) || Path[PathIndex] != Head)
+    {
+        ClearPath();
+        return false;
+    }
+
+    // Bodies move every tile, so re-check the next few steps; anything further out is
+    // checked once it comes into range
+    const int32 LastChecked = FMath::Min(Path.Num() - 1, PathIndex + PathCheckHorizon);
+    for (int32 i = PathIndex + 1; i <= LastChecked; ++i)
+    {
+        if (!Sim.IsBlocked(Path[i]))
         {
-            FVector Next = Curr + Dir;
-            if (!Walkable.Contains(Next)
-             || CameFrom.Contains(Next)
-             || BodyTiles.Contains(Next))
-            {
-                continue;
-            }
-            CameFrom.Add(Next, Curr);
-            Q.push(Next);
+            continue;
+        }
+
+        int32 Rejoin = i + 1;
+        while (Rejoin < Path.Num() && Sim.IsBlocked(Path[Rejoin]))
+        {
+            ++Rejoin;
         }
+        if (Rejoin >= Path.Num() || !Pathfinder.FindPath(Sim, Head, Path[Rejoin], Detour, GetPathAlgorithm()))
+        {
+            ClearPath();
+            return false;
+        }
+
+        // Detour ends on Path[Rejoin], keep the untouched rest of the plan after it
+        Detour.Append(Path.GetData() + Rejoin + 1, Path.Num() - Rejoin - 1);
+        Swap(Path, Detour);
+        PathIndex = 0;
+        break;
     }
 
-    // Reconstruct path after goal reached
-    if (!CameFrom.Contains(G))
+    return Path.Num() - PathIndex >= 2;
+}
+
+void ASnakeAIController::ClearPath()
+{
+    Path.Reset();
+    PathIndex = 0;
+    PathGoal = FIntPoint::NoneValue;
+}
+
+bool ASnakeAIController::AdoptPathQuery(const FIntPoint& Head, const FIntPoint& Goal)
+{
+    if (!PathQuery.IsValid() || !PathQuery.IsCompleted())
+    {
         return false;
+    }
 
-    // Build reversed path
-    TArray<FVector> ReversePath;
-    for (FVector At = G; At != S; At = CameFrom[At])
-        ReversePath.Add(At);
-    ReversePath.Add(S);
+    FPathQueryResult& Result = PathQuery.GetResult();
+    const bool bUsable = Result.bFound && Result.Goal == Goal && Result.Path[0] == Head;
+    if (bUsable)
+    {
+        Swap(Path, Result.Path);
+        PathIndex = 0;
+        PathGoal = Goal;
+    }
+    PathQuery = {};
+    return bUsable;
+}
 
-    // Flip into OutPath
-    for (int32 i = ReversePath.Num() - 1; i >= 0; --i)
-        OutPath.Add(ReversePath[i]);
+void ASnakeAIController::LaunchPathQuery(const FSnakeSimulation& Sim, const FIntPoint& From, const FIntPoint& Goal)
+{
+    if (PathQuery.IsValid() && !PathQuery.IsCompleted())
+    {
+        return;
+    }
 
-    return true;
+    // The snapshot is shared with the simulation's cache and never written after it is built
+    PathQuery = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+        [Finder = AsyncPathfinder, Snapshot = Sim.GetSnapshot(), From, Goal, Algorithm = GetPathAlgorithm()]()
+        {
+            FPathQueryResult Result;
+            Result.Goal = Goal;
+            Result.bFound = Finder->FindPath(*Snapshot, From, Goal, Result.Path, Algorithm) && Result.Path.Num() >= 2;
+            return Result;
+        });
+}
+
+ESnakeDirection ASnakeAIController::ChooseSafeDirection(const FSnakeSimulation& Sim, const FIntPoint& Head, const FIntPoint& Goal, ESnakeDirection Current)
+{
+    return ChooseStep(Sim, Head, Current, [&Goal](const FIntPoint& Cell)
+    {
+        return FMath::Abs(Goal.X - Cell.X) + FMath::Abs(Goal.Y - Cell.Y);
+    });
 }
 
+ESnakeDirection ASnakeAIController::ChooseStep(const FSnakeSimulation& Sim, const FIntPoint& Head, ESnakeDirection Current, TFunctionRef<int32(const FIntPoint&)> CellCost)
+{
+    static const ESnakeDirection Directions[] = {
+        ESnakeDirection::Up, ESnakeDirection::Right, ESnakeDirection::Down, ESnakeDirection::Left
+    };
+
+    const FIntPoint Forward = FSnakeSimulation::GetDirectionOffset(Current);
+    ESnakeDirection Best = ESnakeDirection::None;
+    int64 BestScore = MAX_int64;
+    for (const ESnakeDirection Dir : Directions)
+    {
+        const FIntPoint Offset = FSnakeSimulation::GetDirectionOffset(Dir);
+        const FIntPoint Next = Head + Offset;
+        if ((Current != ESnakeDirection::None && Offset + Forward == FIntPoint::ZeroValue) || Sim.IsBlocked(Next))
+        {
+            continue;
+        }
+
+        // Cost counts double so keeping the current heading only breaks ties
+        const int64 Score = 2 * int64(CellCost(Next)) + (Dir == Current ? 0 : 1);
+        if (Score < BestScore)
+        {
+            BestScore = Score;
+            Best = Dir;
+        }
+    }
+    return Best;
+}
@@ -4,8 +4,26 @@
 #include "CoreMinimal.h"
 #include "AIController.h"
 #include "Definitions.h"          // for TileSize & ESnakeDirection
+#include "SnakePathfinder.h"
+#include "SnakeSurvivalPlanner.h"
+#include "Tasks/Task.h"
 #include "SnakeAIController.generated.h"
 
+class ASnakePawn;
+class ASnakeWorld;
+
+/** How an AI snake finds its way to the nearest apple. */
+UENUM(BlueprintType)
+enum class ESnakeAIPathMode : uint8
+{
+    // Step downhill on the food distance field the world shares between all AI snakes
+    DistanceField,
+    // Own A* path to the nearest apple, cached and replanned on a worker thread
+    AStar,
+    // Same as AStar but searched with Jump Point Search, cheaper on large open levels
+    JumpPoint
+};
+
 UCLASS()
 class SNAKEGAME_API ASnakeAIController : public AAIController
 {
@@ -13,11 +31,93 @@ class SNAKEGAME_API ASnakeAIController : public AAIController
 
 public:
     ASnakeAIController();
-    virtual void Tick(float DeltaTime) override;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="AI")
+    ESnakeAIPathMode PathMode = ESnakeAIPathMode::DistanceField;
+
+    /**
+     * CPU time in microseconds each move may spend checking that eating the apple does not trap
+     * the snake. Higher is a harder opponent; 0 turns the check off and the snake chases greedily.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="AI", meta=(ClampMin="0"))
+    int32 PlannerBudgetMicroseconds = 500;
+
+    /** How many steps ahead of the head the cached path is re-checked on every tile (AStar and JumpPoint). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="AI", meta=(ClampMin="1"))
+    int32 PathCheckHorizon = 8;
+
+    // ─── Driven by USnakeAIManagerSubsystem ──────────────────────────
+    /** True once per tile the pawn enters, with the cell it is now in. Game thread. */
+    bool ConsumeNewTile(const ASnakeWorld& World, FIntPoint& OutHead);
+
+    /**
+     * Picks the next move from Head. Only touches this controller's own state and reads the
+     * simulation, so the manager may run it for several controllers in parallel.
+     */
+    ESnakeDirection DecideDirection(const FSnakeSimulation& Sim, const FSnakeDistanceField& Field, const ASnakePawn& Snake, const FIntPoint& Head);
+
+    /** Turns the pawn and draws the debug plan. Game thread. */
+    void ApplyDirection(const ASnakeWorld& World, ESnakeDirection Dir);
+
+    /** Forgets the current plan, for when the pawn is put back to its start. */
+    void ResetPlan();
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
-    bool FindPath(const FVector& Start, const FVector& Goal, TArray<FVector>& OutPath) const;
-    static FVector SnapToGrid(const FVector& WorldPos);
-    
+    struct FPathQueryResult
+    {
+        FIntPoint Goal = FIntPoint::NoneValue;
+        TArray<FIntPoint> Path;
+        bool bFound = false;
+    };
+
+    static ESnakeDirection FollowDistanceField(const FSnakeSimulation& Sim, const FSnakeDistanceField& Field, const FIntPoint& Head, ESnakeDirection Current);
+    ESnakeDirection FollowPath(const FSnakeSimulation& Sim, const FIntPoint& Head, const FIntPoint& Goal, ESnakeDirection Current);
+
+    /**
+     * Advances the cached path to Head. Returns false when the goal changed or the snake left the
+     * path, which needs a full search; a blocked step inside the horizon is repaired in place with
+     * a detour to the first free step after it.
+     */
+    bool UpdatePath(const FSnakeSimulation& Sim, const FIntPoint& Head, const FIntPoint& Goal);
+    void ClearPath();
+
+    ESnakePathAlgorithm GetPathAlgorithm() const
+    {
+        return PathMode == ESnakeAIPathMode::JumpPoint ? ESnakePathAlgorithm::JumpPoint : ESnakePathAlgorithm::AStar;
+    }
+
+    /** Takes the finished worker search when it was planned from Head towards Goal. */
+    bool AdoptPathQuery(const FIntPoint& Head, const FIntPoint& Goal);
+
+    /** Searches From -> Goal on a worker against a snapshot of the grid. One query at a time. */
+    void LaunchPathQuery(const FSnakeSimulation& Sim, const FIntPoint& From, const FIntPoint& Goal);
+
+    /** Free neighbour closest to Goal, keeping Current on ties; used while a search is in flight. */
+    static ESnakeDirection ChooseSafeDirection(const FSnakeSimulation& Sim, const FIntPoint& Head, const FIntPoint& Goal, ESnakeDirection Current);
+
+    /** Free, non-reversing neighbour of Head with the lowest CellCost. */
+    static ESnakeDirection ChooseStep(const FSnakeSimulation& Sim, const FIntPoint& Head, ESnakeDirection Current, TFunctionRef<int32(const FIntPoint&)> CellCost);
+
+    // Reused between ticks so a search allocates nothing once the buffers fit the level. The
+    // worker gets its own instance, shared so it outlives the controller if a query is in flight.
+    FSnakePathfinder Pathfinder;
+    FSnakeSurvivalPlanner SurvivalPlanner;
+    TSharedRef<FSnakePathfinder> AsyncPathfinder = MakeShared<FSnakePathfinder>();
+    UE::Tasks::TTask<FPathQueryResult> PathQuery;
+
+    TArray<FIntPoint> Path;
+    TArray<FIntPoint> Detour;
+
+    // Index of the head's cell in Path and the goal Path leads to
+    int32 PathIndex = 0;
+    FIntPoint PathGoal = FIntPoint::NoneValue;
+
+    // Apple the last decision went for, drawn by ApplyDirection
+    FIntPoint DebugGoal = FIntPoint::NoneValue;
+
     FVector PrevTilePosition = FVector(FLT_MAX);
 };
@@ -0,0 +1,62 @@
+#include "SnakeAIManagerSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "SnakeAIController.h"
+#include "SnakePawn.h"
+#include "SnakeWorld.h"
+
+void USnakeAIManagerSubsystem::RegisterController(ASnakeAIController* Controller)
+{
+	if (Controller)
+	{
+		Controllers.AddUnique(Controller);
+	}
+}
+
+void USnakeAIManagerSubsystem::UnregisterController(ASnakeAIController* Controller)
+{
+	Controllers.RemoveSingleSwap(Controller);
+}
+
+bool USnakeAIManagerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USnakeAIManagerSubsystem::UpdateControllers(ASnakeWorld& World)
+{
+	if (Controllers.Num() == 0)
+	{
+		return;
+	}
+
+	Pending.Reset();
+	for (ASnakeAIController* Controller : Controllers)
+	{
+		FIntPoint Head;
+		if (IsValid(Controller) && Controller->ConsumeNewTile(World, Head))
+		{
+			Pending.Add({ Controller, Cast<ASnakePawn>(Controller->GetPawn()), Head });
+		}
+	}
+	if (Pending.Num() == 0)
+	{
+		return;
+	}
+
+	// Build the lazily cached field and snapshot here, the decisions below only read them
+	const FSnakeSimulation& Sim = World.GetSimulation();
+	const FSnakeDistanceField& Field = Sim.GetFoodDistanceField();
+	Sim.GetSnapshot();
+
+	ParallelFor(Pending.Num(), [this, &Sim, &Field](int32 Index)
+	{
+		FPendingDecision& Decision = Pending[Index];
+		Decision.Direction = Decision.Controller->DecideDirection(Sim, Field, *Decision.Snake, Decision.Head);
+	}, Pending.Num() < ParallelThreshold ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	for (const FPendingDecision& Decision : Pending)
+	{
+		Decision.Controller->ApplyDirection(World, Decision.Direction);
+	}
+}
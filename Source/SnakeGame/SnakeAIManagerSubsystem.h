@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Definitions.h"
+#include "SnakeAIManagerSubsystem.generated.h"
+
+class ASnakeAIController;
+class ASnakePawn;
+class ASnakeWorld;
+
+/**
+ * Drives every AI snake of a world. On every fixed simulation step, called by
+ * USnakeTickManagerSubsystem after the snakes moved, it collects the controllers whose pawn
+ * entered a new tile and decides their moves
+ * in one pass over the shared simulation data, spread over worker threads once there are enough of
+ * them; the controllers themselves never tick.
+ */
+UCLASS()
+class SNAKEGAME_API USnakeAIManagerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterController(ASnakeAIController* Controller);
+	void UnregisterController(ASnakeAIController* Controller);
+
+	/** Decides and applies the moves of every controller whose snake reached a new tile. */
+	void UpdateControllers(ASnakeWorld& World);
+
+	// Fewer decisions than this in a step are made on the game thread, below it the task
+	// overhead outweighs the work
+	static constexpr int32 ParallelThreshold = 4;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPendingDecision
+	{
+		ASnakeAIController* Controller = nullptr;
+		const ASnakePawn* Snake = nullptr;
+		FIntPoint Head = FIntPoint::ZeroValue;
+		ESnakeDirection Direction = ESnakeDirection::None;
+	};
+
+	UPROPERTY()
+	TArray<ASnakeAIController*> Controllers;
+
+	// Reused every step
+	TArray<FPendingDecision> Pending;
+};
@@ -0,0 +1,99 @@
+#include "SnakeActorPool.h"
+
+#include "Engine/World.h"
+
+void FSnakeActorPool::Prewarm(UWorld* World, TSubclassOf<AActor> Class, int32 Count)
+{
+	if (!World || !Class)
+	{
+		return;
+	}
+	if (PooledClass != Class)
+	{
+		Empty();
+		PooledClass = Class;
+	}
+
+	while (Free.Num() < Count)
+	{
+		AActor* Actor = Spawn(World, FTransform::Identity);
+		if (!Actor)
+		{
+			break;
+		}
+		Deactivate(Actor);
+		Free.Add(Actor);
+	}
+}
+
+AActor* FSnakeActorPool::Acquire(UWorld* World, TSubclassOf<AActor> Class, const FTransform& Transform)
+{
+	if (!World || !Class)
+	{
+		return nullptr;
+	}
+	if (PooledClass != Class)
+	{
+		Empty();
+		PooledClass = Class;
+	}
+
+	while (Free.Num() > 0)
+	{
+		AActor* Actor = Free.Pop(EAllowShrinking::No);
+		if (!IsValid(Actor))
+		{
+			continue;
+		}
+
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+		Actor->SetActorHiddenInGame(false);
+		Actor->SetActorEnableCollision(true);
+		Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+		return Actor;
+	}
+
+	return Spawn(World, Transform);
+}
+
+void FSnakeActorPool::Release(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+	if (Actor->GetClass() != PooledClass)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	Deactivate(Actor);
+	Free.Add(Actor);
+}
+
+void FSnakeActorPool::Empty()
+{
+	for (AActor* Actor : Free)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+	Free.Empty();
+}
+
+AActor* FSnakeActorPool::Spawn(UWorld* World, const FTransform& Transform) const
+{
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AActor>(PooledClass, Transform, Params);
+}
+
+void FSnakeActorPool::Deactivate(AActor* Actor)
+{
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SnakeActorPool.generated.h"
+
+/**
+ * Recycles actors of one class instead of destroying and respawning them. Released actors are
+ * hidden, stripped of collision and tick and kept for the next Acquire, which teleports them
+ * into place and turns them back on. Owners hold it as a UPROPERTY so the pooled actors stay
+ * referenced.
+ */
+USTRUCT()
+struct SNAKEGAME_API FSnakeActorPool
+{
+	GENERATED_BODY()
+
+	/** Makes sure at least Count actors of Class are waiting in the pool. */
+	void Prewarm(UWorld* World, TSubclassOf<AActor> Class, int32 Count);
+
+	/** A pooled actor of Class moved to Transform and enabled, spawning one if none is free. */
+	AActor* Acquire(UWorld* World, TSubclassOf<AActor> Class, const FTransform& Transform);
+
+	/** Disables Actor and keeps it for a later Acquire. */
+	void Release(AActor* Actor);
+
+	/** Destroys the actors waiting in the pool; acquired ones are left alone. */
+	void Empty();
+
+	int32 NumFree() const { return Free.Num(); }
+
+private:
+	AActor* Spawn(UWorld* World, const FTransform& Transform) const;
+	static void Deactivate(AActor* Actor);
+
+	// The pool serves one class; asking for another one drops the free actors of the old class
+	UPROPERTY()
+	TSubclassOf<AActor> PooledClass;
+
+	UPROPERTY()
+	TArray<AActor*> Free;
+};
@@ -0,0 +1,109 @@
+#include "SnakeActorRegistry.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "SnakePawn.h"
+#include "SnakeWorld.h"
+
+USnakeActorRegistry* USnakeActorRegistry::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<USnakeActorRegistry>() : nullptr;
+}
+
+void USnakeActorRegistry::RegisterWorld(ASnakeWorld* World)
+{
+	if (SnakeWorld && SnakeWorld != World)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[Registry] %s replaces %s as the snake world."),
+			*GetNameSafe(World), *GetNameSafe(SnakeWorld));
+	}
+	SnakeWorld = World;
+}
+
+void USnakeActorRegistry::UnregisterWorld(ASnakeWorld* World)
+{
+	if (SnakeWorld == World)
+	{
+		SnakeWorld = nullptr;
+	}
+}
+
+void USnakeActorRegistry::RegisterFood(const FIntPoint& Cell, AActor* Food)
+{
+	if (Food)
+	{
+		FoodsByCell.Add(Cell, Food);
+	}
+}
+
+AActor* USnakeActorRegistry::UnregisterFood(const FIntPoint& Cell)
+{
+	AActor* Food = nullptr;
+	FoodsByCell.RemoveAndCopyValue(Cell, Food);
+	return Food;
+}
+
+void USnakeActorRegistry::UnregisterAllFood()
+{
+	FoodsByCell.Reset();
+}
+
+void USnakeActorRegistry::RegisterSnake(ASnakePawn* Snake)
+{
+	if (Snake)
+	{
+		Snakes.AddUnique(Snake);
+		if (Snake->SnakeId != INDEX_NONE)
+		{
+			SnakesById.Add(Snake->SnakeId, Snake);
+		}
+	}
+}
+
+void USnakeActorRegistry::UnregisterSnake(ASnakePawn* Snake)
+{
+	if (Snake)
+	{
+		Snakes.RemoveSingleSwap(Snake);
+		if (FindSnake(Snake->SnakeId) == Snake)
+		{
+			SnakesById.Remove(Snake->SnakeId);
+		}
+	}
+}
+
+ASnakePawn* USnakeActorRegistry::FindSnake(int32 SnakeId) const
+{
+	ASnakePawn* const* Snake = SnakesById.Find(SnakeId);
+	return Snake ? *Snake : nullptr;
+}
+
+APlayerStart* USnakeActorRegistry::FindPlayerStart(FName Tag)
+{
+	if (!bPlayerStartsIndexed)
+	{
+		IndexPlayerStarts();
+	}
+
+	const TWeakObjectPtr<APlayerStart>* Start = PlayerStartsByTag.Find(Tag);
+	return Start ? Start->Get() : nullptr;
+}
+
+void USnakeActorRegistry::IndexPlayerStarts()
+{
+	// Placed in the level and never spawned at runtime, so one pass over them is enough
+	bPlayerStartsIndexed = true;
+	PlayerStartsByTag.Reset();
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		for (const FName& Tag : It->Tags)
+		{
+			if (!PlayerStartsByTag.Contains(Tag))
+			{
+				PlayerStartsByTag.Add(Tag, *It);
+			}
+		}
+	}
+}
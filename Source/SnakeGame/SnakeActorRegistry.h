@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SnakeActorRegistry.generated.h"
+
+class APlayerStart;
+class ASnakePawn;
+class ASnakeWorld;
+
+/**
+ * Index of the gameplay actors other code needs to find, so nothing on a gameplay path has to
+ * iterate the world's actors. The snake world and snakes add themselves when they start
+ * and remove themselves when they end play. Food is indexed by its cell, by ASnakeWorld as it
+ * places and removes the pooled actors. Player starts are engine actors and cannot register, so
+ * they are indexed by tag the first time one is asked for.
+ */
+UCLASS()
+class SNAKEGAME_API USnakeActorRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static USnakeActorRegistry* Get(const UObject* WorldContextObject);
+
+	// ─── Snake world ─────────────────────────────────────────────────
+	void RegisterWorld(ASnakeWorld* World);
+	void UnregisterWorld(ASnakeWorld* World);
+	ASnakeWorld* GetSnakeWorld() const { return SnakeWorld; }
+
+	// ─── Food ────────────────────────────────────────────────────────
+	void RegisterFood(const FIntPoint& Cell, AActor* Food);
+	/** Removes and returns the food on Cell, or null. */
+	AActor* UnregisterFood(const FIntPoint& Cell);
+	void UnregisterAllFood();
+	const TMap<FIntPoint, AActor*>& GetFoods() const { return FoodsByCell; }
+
+	// ─── Snakes ──────────────────────────────────────────────────────
+	void RegisterSnake(ASnakePawn* Snake);
+	void UnregisterSnake(ASnakePawn* Snake);
+	const TArray<ASnakePawn*>& GetSnakes() const { return Snakes; }
+
+	/** Pawn of a simulation snake id, or null. */
+	ASnakePawn* FindSnake(int32 SnakeId) const;
+
+	// ─── Player starts ───────────────────────────────────────────────
+	/** First player start carrying Tag, or null. */
+	APlayerStart* FindPlayerStart(FName Tag);
+
+private:
+	void IndexPlayerStarts();
+
+	UPROPERTY()
+	ASnakeWorld* SnakeWorld = nullptr;
+
+	UPROPERTY()
+	TMap<FIntPoint, AActor*> FoodsByCell;
+
+	UPROPERTY()
+	TArray<ASnakePawn*> Snakes;
+
+	TMap<int32, ASnakePawn*> SnakesById;
+
+	TMap<FName, TWeakObjectPtr<APlayerStart>> PlayerStartsByTag;
+	bool bPlayerStartsIndexed = false;
+};
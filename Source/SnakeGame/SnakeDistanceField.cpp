@@ -0,0 +1,66 @@
+#include "SnakeDistanceField.h"
+
+void FSnakeDistanceField::Reset()
+{
+	Width = 0;
+	Height = 0;
+	Sources.Reset();
+	Distance.Reset();
+	Nearest.Reset();
+}
+
+void FSnakeDistanceField::Build(int32 InWidth, int32 InHeight, const TArray<ESnakeCell>& Terrain, const TArray<FIntPoint>& InSources)
+{
+	Width = InWidth;
+	Height = InHeight;
+	Sources = InSources;
+
+	const int32 NumCells = Width * Height;
+	Distance.Init(Unreachable, NumCells);
+	Nearest.SetNumUninitialized(NumCells);
+
+	// Every cell enters the queue once, so a flat array with a read cursor is enough
+	Queue.Reset(NumCells);
+	for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+	{
+		const FIntPoint& Source = Sources[SourceIndex];
+		if (!IsInBounds(Source))
+		{
+			continue;
+		}
+
+		const int32 Index = Source.Y * Width + Source.X;
+		if (Distance[Index] == Unreachable)
+		{
+			Distance[Index] = 0;
+			Nearest[Index] = SourceIndex;
+			Queue.Add(Index);
+		}
+	}
+
+	for (int32 Read = 0; Read < Queue.Num(); ++Read)
+	{
+		const int32 Index = Queue[Read];
+		const int32 X = Index % Width;
+		const int32 Y = Index / Width;
+		const int32 Neighbours[4] = {
+			Y > 0          ? Index - Width : INDEX_NONE,
+			X < Width - 1  ? Index + 1     : INDEX_NONE,
+			Y < Height - 1 ? Index + Width : INDEX_NONE,
+			X > 0          ? Index - 1     : INDEX_NONE
+		};
+
+		for (const int32 Next : Neighbours)
+		{
+			if (Next == INDEX_NONE || Distance[Next] != Unreachable
+				|| (Terrain[Next] != ESnakeCell::Floor && Terrain[Next] != ESnakeCell::Door))
+			{
+				continue;
+			}
+
+			Distance[Next] = Distance[Index] + 1;
+			Nearest[Next] = Nearest[Index];
+			Queue.Add(Next);
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SnakeLevelData.h"
+
+/**
+ * Walking distance from every cell of a level to the nearest of a set of source cells, plus which
+ * source that is. Built with one breadth-first pass seeded with all sources at once, so the cost
+ * does not grow with the number of sources or of the snakes reading it.
+ *
+ * Only terrain blocks the way: bodies move every tile and would invalidate the field each step,
+ * readers check them on the cell they are about to enter instead.
+ */
+class SNAKEGAME_API FSnakeDistanceField
+{
+public:
+	static constexpr int32 Unreachable = MAX_int32;
+
+	void Build(int32 InWidth, int32 InHeight, const TArray<ESnakeCell>& Terrain, const TArray<FIntPoint>& InSources);
+	void Reset();
+
+	bool IsInBounds(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	/** Steps to the nearest source, Unreachable outside the level or when walled off. */
+	int32 GetDistance(const FIntPoint& Cell) const
+	{
+		return IsInBounds(Cell) ? Distance[Cell.Y * Width + Cell.X] : Unreachable;
+	}
+
+	bool IsReachable(const FIntPoint& Cell) const { return GetDistance(Cell) != Unreachable; }
+
+	/** Source the distance at Cell was measured to. Only meaningful when Cell is reachable. */
+	FIntPoint GetNearestSource(const FIntPoint& Cell) const
+	{
+		return Sources[Nearest[Cell.Y * Width + Cell.X]];
+	}
+
+private:
+	int32 Width = 0;
+	int32 Height = 0;
+
+	TArray<FIntPoint> Sources;
+
+	// Row-major like the level; Nearest is an index into Sources
+	TArray<int32> Distance;
+	TArray<int32> Nearest;
+
+	// BFS frontier, kept to avoid reallocating on every rebuild
+	TArray<int32> Queue;
+};
@@ -0,0 +1,144 @@
+#include "SnakeEffectsSubsystem.h"
+
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Sound/SoundBase.h"
+#include "Definitions.h"
+
+namespace
+{
+	bool IsSameCell(const FVector& A, const FVector& B)
+	{
+		return FVector::DistSquared2D(A, B) < FMath::Square(TileSize * 0.5f);
+	}
+}
+
+void USnakeEffectsSubsystem::QueueEmitter(UParticleSystem* Template, const FVector& Location)
+{
+	if (!Template || Queue.Num() >= MaxQueuedEffects)
+	{
+		return;
+	}
+
+	// Two snakes reaching the same apple in one frame get one burst, not two on top of each other
+	const bool bQueued = Queue.ContainsByPredicate([Template, &Location](const FQueuedEffect& Effect)
+	{
+		return Effect.Emitter == Template && IsSameCell(Effect.Location, Location);
+	});
+	if (!bQueued)
+	{
+		Queue.Add({ Template, nullptr, Location });
+	}
+}
+
+void USnakeEffectsSubsystem::QueueSound(USoundBase* Sound, const FVector& Location)
+{
+	if (!Sound || Queue.Num() >= MaxQueuedEffects)
+	{
+		return;
+	}
+
+	// Several snakes eating in the same frame would only stack the same sample louder
+	const bool bQueued = Queue.ContainsByPredicate([Sound](const FQueuedEffect& Effect) { return Effect.Sound == Sound; });
+	if (!bQueued)
+	{
+		Queue.Add({ nullptr, Sound, Location });
+	}
+}
+
+TStatId USnakeEffectsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USnakeEffectsSubsystem, STATGROUP_Tickables);
+}
+
+bool USnakeEffectsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USnakeEffectsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// One pass that compacts the requests still waiting to the front, in their original order
+	int32 Started = 0;
+	int32 Kept = 0;
+	for (int32 Index = 0; Index < Queue.Num(); ++Index)
+	{
+		const FQueuedEffect& Effect = Queue[Index];
+		if (Started < MaxEffectsPerFrame && (Effect.Emitter ? PlayEmitter(Effect) : PlaySound(Effect)))
+		{
+			++Started;
+			continue;
+		}
+
+		// Over budget or pool exhausted, keep it for a later frame
+		if (Kept != Index)
+		{
+			Queue[Kept] = Effect;
+		}
+		++Kept;
+	}
+	Queue.SetNum(Kept, EAllowShrinking::No);
+}
+
+bool USnakeEffectsSubsystem::PlayEmitter(const FQueuedEffect& Effect)
+{
+	for (UParticleSystemComponent* Component : EmitterPool)
+	{
+		if (IsValid(Component) && !Component->IsActive())
+		{
+			if (Component->Template != Effect.Emitter)
+			{
+				Component->SetTemplate(Effect.Emitter);
+			}
+			Component->SetWorldLocation(Effect.Location);
+			Component->ActivateSystem(true);
+			return true;
+		}
+	}
+
+	if (EmitterPool.Num() >= MaxPooledComponents)
+	{
+		return false;
+	}
+
+	// Not auto-destroyed, a finished system just deactivates and waits here to be reused
+	UParticleSystemComponent* Component = UGameplayStatics::SpawnEmitterAtLocation(
+		GetWorld(), Effect.Emitter, Effect.Location, FRotator::ZeroRotator, FVector::OneVector, false);
+	if (Component)
+	{
+		EmitterPool.Add(Component);
+	}
+	return Component != nullptr;
+}
+
+bool USnakeEffectsSubsystem::PlaySound(const FQueuedEffect& Effect)
+{
+	for (UAudioComponent* Component : AudioPool)
+	{
+		if (IsValid(Component) && !Component->IsPlaying())
+		{
+			Component->SetSound(Effect.Sound);
+			Component->SetWorldLocation(Effect.Location);
+			Component->Play();
+			return true;
+		}
+	}
+
+	if (AudioPool.Num() >= MaxPooledComponents)
+	{
+		return false;
+	}
+
+	UAudioComponent* Component = UGameplayStatics::SpawnSoundAtLocation(
+		GetWorld(), Effect.Sound, Effect.Location, FRotator::ZeroRotator, 1.0f, 1.0f, 0.0f,
+		nullptr, nullptr, false);
+	if (Component)
+	{
+		AudioPool.Add(Component);
+	}
+	return Component != nullptr;
+}
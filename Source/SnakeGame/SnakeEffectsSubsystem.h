@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SnakeEffectsSubsystem.generated.h"
+
+class UAudioComponent;
+class UParticleSystem;
+class UParticleSystemComponent;
+class USoundBase;
+
+/**
+ * Plays the one-shot particles and sounds gameplay asks for. Requests are queued and drained once
+ * per frame up to a budget; the same sound queued twice in a frame plays once, as does the same
+ * emitter queued twice for one cell. Emitters and audio come from small pools of components that
+ * are rewound instead of spawned per event.
+ */
+UCLASS()
+class SNAKEGAME_API USnakeEffectsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void QueueEmitter(UParticleSystem* Template, const FVector& Location);
+	void QueueSound(USoundBase* Sound, const FVector& Location);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Effects started per frame; the rest wait for the next one
+	static constexpr int32 MaxEffectsPerFrame = 8;
+
+	// Requests beyond this are dropped, a backlog of stale effects is worse than a missing one
+	static constexpr int32 MaxQueuedEffects = 64;
+
+	// Components kept per kind; when all are busy the request waits for one to finish
+	static constexpr int32 MaxPooledComponents = 16;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FQueuedEffect
+	{
+		UParticleSystem* Emitter = nullptr;
+		USoundBase* Sound = nullptr;
+		FVector Location = FVector::ZeroVector;
+	};
+
+	/** True when the effect was started, false when no component is free for it this frame. */
+	bool PlayEmitter(const FQueuedEffect& Effect);
+	bool PlaySound(const FQueuedEffect& Effect);
+
+	TArray<FQueuedEffect> Queue;
+
+	// Created through UGameplayStatics, which parents location-only components to the world
+	// settings actor. That actor lives exactly as long as the world, like this subsystem, so the
+	// pools survive level loads and go away with the world without an owner actor of our own.
+	// Held here so finished ones can be restarted.
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> EmitterPool;
+
+	UPROPERTY()
+	TArray<UAudioComponent*> AudioPool;
+};
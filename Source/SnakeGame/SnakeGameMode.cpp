@@ -4,10 +4,10 @@
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerController.h"
 #include "SnakeWorld.h"
+#include "SnakeActorRegistry.h"
 #include "SnakeAIController.h"
 #include "Engine/LocalPlayer.h"
 #include "GameFramework/PlayerStart.h"
-#include "EngineUtils.h"
 #include "Components/AudioComponent.h"
 
 EGameType ASnakeGameMode::ToV2Variant(EGameType BaseType)
@@ -37,9 +37,7 @@ EGameType ASnakeGameMode::ToBaseVariant(EGameType Type)
 }
 
 ASnakeGameMode::ASnakeGameMode()
-    : CurrentWidget(nullptr)
-    , PauseWidget(nullptr)
-    , InGameWidget(nullptr)
+    : InGameWidget(nullptr)
     , SpawnedAISnake(nullptr)
     , ApplesToFinish(5)
     , ApplesEaten(0)
@@ -106,6 +104,7 @@ void ASnakeGameMode::SetGameType(EGameType NewType)
 
     // Core spawn logic  
     CurrentGameType = NewType;
+    ApplyScoreLayout();
     UE_LOG(LogTemp, Log, TEXT("GameType set to %s"),
            *UEnum::GetValueAsString(NewType));
 
@@ -126,17 +125,7 @@ void ASnakeGameMode::SetGameType(EGameType NewType)
         if (!IsValid(SpawnedAISnake))
         {
             FTransform SpawnT;
-            APlayerStart* P2 = nullptr;
-            TArray<AActor*> Starts;
-            UGameplayStatics::GetAllActorsOfClass(W, APlayerStart::StaticClass(), Starts);
-            for (AActor* A : Starts)
-            {
-                if (A->ActorHasTag(TEXT("PlayerStart2")))
-                {
-                    P2 = Cast<APlayerStart>(A);
-                    break;
-                }
-            }
+            APlayerStart* P2 = GetRegistry() ? GetRegistry()->FindPlayerStart(TEXT("PlayerStart2")) : nullptr;
 
             if (P2)
             {
@@ -163,6 +152,7 @@ void ASnakeGameMode::SetGameType(EGameType NewType)
                 if (NewAI)
                 {
                     SpawnedAISnake = NewAI;
+                    NewAI->SetTailColor(AITailColor);
                     ASnakeAIController* AICon = W->SpawnActor<ASnakeAIController>(
                         ASnakeAIController::StaticClass());
                     if (AICon)
@@ -191,17 +181,7 @@ void ASnakeGameMode::PostLogin(APlayerController* NewPlayer)
     int32 Id = NewPlayer->GetLocalPlayer()->GetControllerId();
     if (Id == 1 && (CurrentGameType == EGameType::Coop || CurrentGameType == EGameType::PvP))
     {
-        APlayerStart* TargetStart = nullptr;
-        TArray<AActor*> Starts;
-        UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), Starts);
-        for (AActor* Actor : Starts)
-        {
-            if (Actor->ActorHasTag(TEXT("PlayerStart2")))
-            {
-                TargetStart = Cast<APlayerStart>(Actor);
-                break;
-            }
-        }
+        APlayerStart* TargetStart = GetRegistry() ? GetRegistry()->FindPlayerStart(TEXT("PlayerStart2")) : nullptr;
 
         FTransform SpawnTransform;
         if (TargetStart)
@@ -228,6 +208,7 @@ void ASnakeGameMode::PostLogin(APlayerController* NewPlayer)
                 Player2PawnBP, SpawnTransform, Params);
             if (Pawn)
             {
+                Pawn->SetTailColor(Player2TailColor);
                 NewPlayer->Possess(Pawn);
                 UE_LOG(LogTemp, Log,
                        TEXT("Spawned P2 at %s"),
@@ -273,9 +254,7 @@ void ASnakeGameMode::NotifyAppleEaten(int32 ControllerId)
         }
     }
     
-    ASnakeWorld* World = Cast<ASnakeWorld>(
-        UGameplayStatics::GetActorOfClass(GetWorld(), ASnakeWorld::StaticClass())
-    );
+    ASnakeWorld* World = GetSnakeWorld();
     if (!World) return;
     
     int32 EatenThisLevel = (CurrentGameType == EGameType::PvP || CurrentGameType == EGameType::PvAI)
@@ -286,57 +265,96 @@ void ASnakeGameMode::NotifyAppleEaten(int32 ControllerId)
     {
         World->SpawnFood();
     }
+    else if (bInSnakeStep)
+    {
+        bLevelFinishedPending = true;
+    }
     else
     {
-        SetGameState(EGameState::Pause);
-        
-        int32 Next = World->LevelIndex + 1;
-        if (!World->DoesLevelExist(Next))
-        {
-            SetGameState(EGameState::Outro);
-            return;
-        }
-        
-        World->LevelIndex = Next;
-        World->LoadLevelFromText();
-        World->SpawnFood();
-        
-        LevelApplesP1 = 0;
-        LevelApplesP2 = 0;
-        ApplesEaten   = 0;
-        
-        SetGameState(EGameState::Game);
+        AdvanceLevel();
+    }
+}
+
+void ASnakeGameMode::AdvanceLevel()
+{
+    ASnakeWorld* World = GetSnakeWorld();
+    if (!World) return;
+
+    SetGameState(EGameState::Pause);
+    
+    int32 Next = World->LevelIndex + 1;
+    if (!World->DoesLevelExist(Next))
+    {
+        SetGameState(EGameState::Outro);
+        return;
+    }
+    
+    World->LevelIndex = Next;
+    if (!World->LoadLevelFromText())
+    {
+        // The finished level is still in place; end the run there instead of playing on it
+        UE_LOG(LogTemp, Error, TEXT("Level %d exists but could not be loaded, ending the game."), Next);
+        World->LevelIndex = Next - 1;
+        SetGameState(EGameState::Outro);
+        return;
+    }
+    World->SpawnFood();
+    
+    LevelApplesP1 = 0;
+    LevelApplesP2 = 0;
+    ApplesEaten   = 0;
+    
+    SetGameState(EGameState::Game);
+}
+
+void ASnakeGameMode::NotifySnakeDied()
+{
+    if (bInSnakeStep)
+    {
+        bGameOverPending = true;
+    }
+    else if (CurrentState != EGameState::Outro)
+    {
+        SetGameState(EGameState::Outro);
+    }
+}
+
+void ASnakeGameMode::BeginSnakeStep()
+{
+    bInSnakeStep = true;
+    bGameOverPending = false;
+    bLevelFinishedPending = false;
+}
+
+void ASnakeGameMode::EndSnakeStep()
+{
+    bInSnakeStep = false;
+
+    // A death in the same step as the last apple still ends the game
+    if (bGameOverPending)
+    {
+        NotifySnakeDied();
+    }
+    else if (bLevelFinishedPending)
+    {
+        AdvanceLevel();
     }
+    bGameOverPending = false;
+    bLevelFinishedPending = false;
 }
 
 
 void ASnakeGameMode::SetGameState(EGameState NewState)
 {
-    if (CurrentWidget) { CurrentWidget->RemoveFromParent(); CurrentWidget = nullptr; }
-    if (PauseWidget)   { PauseWidget->RemoveFromParent();   PauseWidget   = nullptr; }
+    // Menus are pooled: leaving a state only hides its widget
+    CloseAllMenus();
 
     CurrentState = NewState;
     switch (CurrentState)
     {
     case EGameState::MainMenu:
         UGameplayStatics::SetGamePaused(GetWorld(), true);
-        if (MainMenuWidgetClass)
-        {
-            CurrentWidget = CreateWidget<UUserWidget>(GetWorld(), MainMenuWidgetClass);
-            if (CurrentWidget)
-            {
-                CurrentWidget->AddToViewport();
-                
-                if (APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0))
-                {
-                    PC->bShowMouseCursor = true;
-                    FInputModeUIOnly UIInput;
-                    UIInput.SetWidgetToFocus( CurrentWidget->TakeWidget() );
-                    UIInput.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
-                    PC->SetInputMode(UIInput);
-                }
-            }
-        }
+        PushMenu(MainMenuWidgetClass);
         break;
 
     case EGameState::Game:
@@ -347,21 +365,8 @@ void ASnakeGameMode::SetGameState(EGameState NewState)
             if (InGameWidget)
             {
                 InGameWidget->AddToViewport();
-
-                if (CurrentGameType == EGameType::PvP || CurrentGameType == EGameType::PvAI)
-                {
-                    InGameWidget->ScoreText  ->SetVisibility(ESlateVisibility::Collapsed);
-                    InGameWidget->ScoreP1Text->SetVisibility(ESlateVisibility::Visible);
-                    InGameWidget->ScoreP2Text->SetVisibility(ESlateVisibility::Visible);
-                    InGameWidget->SetPlayerScores(TotalApplesP1, TotalApplesP2);
-                }
-                else
-                {
-                    InGameWidget->ScoreText    ->SetVisibility(ESlateVisibility::Visible);
-                    InGameWidget->ScoreP1Text  ->SetVisibility(ESlateVisibility::Collapsed);
-                    InGameWidget->ScoreP2Text  ->SetVisibility(ESlateVisibility::Collapsed);
-                    InGameWidget->SetScore(Score);
-                }
+                InGameWidget->ApplyScoreLayout(HasPerPlayerScores());
+                RefreshScores(InGameWidget);
             }
             else
             {
@@ -370,15 +375,8 @@ void ASnakeGameMode::SetGameState(EGameState NewState)
         }
         if (InGameWidget)
         {
-            if (ASnakeWorld* W = Cast<ASnakeWorld>(
-                    UGameplayStatics::GetActorOfClass(GetWorld(), ASnakeWorld::StaticClass())))
-            {
-                InGameWidget->SetLevel(W->LevelIndex);
-            }
-            else
-            {
-                InGameWidget->SetLevel(1);
-            }
+            ASnakeWorld* W = GetSnakeWorld();
+            InGameWidget->SetLevel(W ? W->LevelIndex : 1);
         }
         if (APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0))
         {
@@ -390,44 +388,9 @@ void ASnakeGameMode::SetGameState(EGameState NewState)
 
     case EGameState::Pause:
         UGameplayStatics::SetGamePaused(GetWorld(), true);
-        if (PauseMenuWidgetClass)
+        if (UMyUserWidget* UW = Cast<UMyUserWidget>(PushMenu(PauseMenuWidgetClass)))
         {
-            auto* UW = CreateWidget<UMyUserWidget>(GetWorld(), PauseMenuWidgetClass);
-            PauseWidget = UW;
-            if (UW)
-            {
-                UW->AddToViewport();
-                
-                if (APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0))
-                {
-                    PC->bShowMouseCursor = true;
-                    FInputModeUIOnly UIInput;
-                    UIInput.SetWidgetToFocus(UW->TakeWidget());
-                    UIInput.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
-                    PC->SetInputMode(UIInput);
-                }
-                
-                if (ASnakeWorld* W = Cast<ASnakeWorld>(
-                        UGameplayStatics::GetActorOfClass(GetWorld(), ASnakeWorld::StaticClass())))
-                {
-                    UW->SetLevel(W->LevelIndex);
-                }
-                if (CurrentGameType == EGameType::PvP || CurrentGameType == EGameType::PvAI)
-                {
-                    UW->ScoreText  ->SetVisibility(ESlateVisibility::Collapsed);
-                    UW->ScoreP1Text->SetVisibility(ESlateVisibility::Visible);
-                    UW->ScoreP2Text->SetVisibility(ESlateVisibility::Visible);
-                    
-                    UW->SetPlayerScores(TotalApplesP1, TotalApplesP2);
-                }
-                else
-                {
-                    UW->ScoreText  ->SetVisibility(ESlateVisibility::Visible);
-                    UW->ScoreP1Text->SetVisibility(ESlateVisibility::Collapsed);
-                    UW->ScoreP2Text->SetVisibility(ESlateVisibility::Collapsed);
-                    UW->SetScore(Score);
-                }
-            }
+            RefreshScores(UW);
         }
         break;
 
@@ -444,47 +407,140 @@ void ASnakeGameMode::SetGameState(EGameState NewState)
                 UGameplayStatics::SpawnSound2D(GetWorld(), GameOverSound);
             }
 
-            auto* UW = CreateWidget<UMyUserWidget>(GetWorld(), GameOverWidgetClass);
-            CurrentWidget = UW;
-            if (UW)
+            if (UMyUserWidget* UW = Cast<UMyUserWidget>(PushMenu(GameOverWidgetClass)))
             {
-                UW->AddToViewport();
-
-                if (APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0))
-                {
-                    PC->bShowMouseCursor = true;
-                    FInputModeUIOnly UIInput;
-                    UIInput.SetWidgetToFocus(UW->TakeWidget());
-                    UIInput.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
-                    PC->SetInputMode(UIInput);
-                }
-                
-                if (ASnakeWorld* W = Cast<ASnakeWorld>(
-                        UGameplayStatics::GetActorOfClass(GetWorld(), ASnakeWorld::StaticClass())))
-                {
-                    UW->SetLevel(W->LevelIndex);
-                }
-                if (CurrentGameType == EGameType::PvP || CurrentGameType == EGameType::PvAI)
-                {
-                    UW->ScoreText  ->SetVisibility(ESlateVisibility::Collapsed);
-                    UW->ScoreP1Text->SetVisibility(ESlateVisibility::Visible);
-                    UW->ScoreP2Text->SetVisibility(ESlateVisibility::Visible);
-                    
-                    UW->SetPlayerScores(TotalApplesP1, TotalApplesP2);
-                }
-                else
-                {
-                    UW->ScoreText  ->SetVisibility(ESlateVisibility::Visible);
-                    UW->ScoreP1Text->SetVisibility(ESlateVisibility::Collapsed);
-                    UW->ScoreP2Text->SetVisibility(ESlateVisibility::Collapsed);
-                    UW->SetScore(Score);
-                }
+                RefreshScores(UW);
             }
         }
         break;
     }
 }
 
+UUserWidget* ASnakeGameMode::PushMenu(TSubclassOf<UUserWidget> WidgetClass)
+{
+    UUserWidget* Widget = GetPooledWidget(WidgetClass);
+    if (!Widget)
+    {
+        return nullptr;
+    }
+
+    // A blueprint may have removed it itself, put it back rather than creating another
+    if (!Widget->IsInViewport())
+    {
+        Widget->AddToViewport(MenuZOrder);
+    }
+    Widget->SetVisibility(ESlateVisibility::Visible);
+
+    MenuStack.Remove(Widget);
+    MenuStack.Push(Widget);
+    FocusMenu(Widget);
+    return Widget;
+}
+
+void ASnakeGameMode::PopMenu()
+{
+    if (MenuStack.Num() == 0)
+    {
+        return;
+    }
+
+    MenuStack.Pop()->SetVisibility(ESlateVisibility::Collapsed);
+    if (MenuStack.Num() > 0)
+    {
+        FocusMenu(MenuStack.Last());
+    }
+    else if (APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0))
+    {
+        PC->bShowMouseCursor = false;
+        PC->SetInputMode(FInputModeGameOnly());
+    }
+}
+
+void ASnakeGameMode::CloseAllMenus()
+{
+    for (UUserWidget* Widget : MenuStack)
+    {
+        if (Widget)
+        {
+            Widget->SetVisibility(ESlateVisibility::Collapsed);
+        }
+    }
+    MenuStack.Reset();
+}
+
+UUserWidget* ASnakeGameMode::GetPooledWidget(TSubclassOf<UUserWidget> WidgetClass)
+{
+    if (!WidgetClass)
+    {
+        return nullptr;
+    }
+    if (UUserWidget** Pooled = WidgetPool.Find(WidgetClass.Get()))
+    {
+        return *Pooled;
+    }
+
+    // First use: create it once, hidden, with the layout of the current game type
+    UUserWidget* Widget = CreateWidget<UUserWidget>(GetWorld(), WidgetClass);
+    if (!Widget)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to create widget from %s"), *GetNameSafe(WidgetClass));
+        return nullptr;
+    }
+    Widget->AddToViewport(MenuZOrder);
+    Widget->SetVisibility(ESlateVisibility::Collapsed);
+    if (UMyUserWidget* UW = Cast<UMyUserWidget>(Widget))
+    {
+        UW->ApplyScoreLayout(HasPerPlayerScores());
+    }
+
+    WidgetPool.Add(WidgetClass.Get(), Widget);
+    return Widget;
+}
+
+void ASnakeGameMode::FocusMenu(UUserWidget* Widget)
+{
+    if (APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0))
+    {
+        PC->bShowMouseCursor = true;
+        FInputModeUIOnly UIInput;
+        UIInput.SetWidgetToFocus(Widget->TakeWidget());
+        UIInput.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
+        PC->SetInputMode(UIInput);
+    }
+}
+
+void ASnakeGameMode::ApplyScoreLayout()
+{
+    const bool bPerPlayer = HasPerPlayerScores();
+    if (InGameWidget)
+    {
+        InGameWidget->ApplyScoreLayout(bPerPlayer);
+    }
+    for (const TPair<UClass*, UUserWidget*>& Pair : WidgetPool)
+    {
+        if (UMyUserWidget* UW = Cast<UMyUserWidget>(Pair.Value))
+        {
+            UW->ApplyScoreLayout(bPerPlayer);
+        }
+    }
+}
+
+void ASnakeGameMode::RefreshScores(UMyUserWidget* Widget) const
+{
+    if (ASnakeWorld* W = GetSnakeWorld())
+    {
+        Widget->SetLevel(W->LevelIndex);
+    }
+    if (HasPerPlayerScores())
+    {
+        Widget->SetPlayerScores(TotalApplesP1, TotalApplesP2);
+    }
+    else
+    {
+        Widget->SetScore(Score);
+    }
+}
+
 
 AActor* ASnakeGameMode::ChoosePlayerStart_Implementation(AController* Controller)
 {
@@ -500,28 +556,79 @@ AActor* ASnakeGameMode::ChoosePlayerStart_Implementation(AController* Controller
     
     FName DesiredTag = (ControllerId == 1) ? TEXT("PlayerStart2") : TEXT("PlayerStart1");
     
-    for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+    if (APlayerStart* Start = GetRegistry() ? GetRegistry()->FindPlayerStart(DesiredTag) : nullptr)
     {
-        if (It->ActorHasTag(DesiredTag))
-        {
-            UE_LOG(LogTemp, Log, TEXT("Spawning Controller %d at %s"), 
-                   ControllerId, *DesiredTag.ToString());
-            return *It;
-        }
+        UE_LOG(LogTemp, Log, TEXT("Spawning Controller %d at %s"), 
+               ControllerId, *DesiredTag.ToString());
+        return Start;
     }
     
     return Super::ChoosePlayerStart_Implementation(Controller);
 }
 
+USnakeActorRegistry* ASnakeGameMode::GetRegistry() const
+{
+    return USnakeActorRegistry::Get(this);
+}
+
+ASnakeWorld* ASnakeGameMode::GetSnakeWorld() const
+{
+    const USnakeActorRegistry* Registry = GetRegistry();
+    return Registry ? Registry->GetSnakeWorld() : nullptr;
+}
+
 void ASnakeGameMode::RestartGame()
 {
-    UWorld* W = GetWorld();
-    if (!W) return;
-    
-    FString MapName = W->GetMapName();
-    MapName.RemoveFromStart(W->StreamingLevelsPrefix);
-    
-    UGameplayStatics::OpenLevel(W, FName(*MapName));
+    // Soft reset in place: actors, widgets and sounds are kept, only the run state goes back
+    Score         = 0;
+    ApplesEaten   = 0;
+    LevelApplesP1 = 0;
+    LevelApplesP2 = 0;
+    TotalApplesP1 = 0;
+    TotalApplesP2 = 0;
+
+    ASnakeWorld* World = GetSnakeWorld();
+    if (World)
+    {
+        World->ResetToStartLevel();
+    }
+
+    // After the level load, so the snakes land in the new grid. The AI snake registers like
+    // any pawn, so it is reset here too and ResetToStart drops its controller's plan.
+    if (USnakeActorRegistry* Registry = GetRegistry())
+    {
+        for (ASnakePawn* Snake : Registry->GetSnakes())
+        {
+            Snake->ResetToStart();
+        }
+    }
+
+    if (World)
+    {
+        World->SpawnFood();
+    }
+
+    if (InGameWidget)
+    {
+        RefreshScores(InGameWidget);
+    }
+    for (const TPair<UClass*, UUserWidget*>& Pair : WidgetPool)
+    {
+        if (UMyUserWidget* UW = Cast<UMyUserWidget>(Pair.Value))
+        {
+            RefreshScores(UW);
+        }
+    }
+
+    if (AmbientAudioComponent && !AmbientAudioComponent->IsPlaying())
+    {
+        AmbientAudioComponent->Play();
+    }
+
+    // Same place a reopened map starts from. CurrentGameType is kept on purpose, it still
+    // matches the AI snake and second player; choosing a mode calls SetGameType, which
+    // removes them or reuses them for the new type.
+    SetGameState(EGameState::MainMenu);
 }
 
 FText ASnakeGameMode::GetCurrentGameTypeText() const
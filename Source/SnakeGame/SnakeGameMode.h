@@ -34,6 +34,8 @@ enum class EGameType : uint8
 };
 
 class UMyUserWidget;
+class ASnakeWorld;
+class USnakeActorRegistry;
 
 UCLASS()
 class SNAKEGAME_API ASnakeGameMode : public AGameModeBase
@@ -93,6 +95,13 @@ public:
     UPROPERTY(EditDefaultsOnly, Category="Spawning")
     TSubclassOf<ASnakePawn> AISnakePawnBP;
 
+    /** Tail colours of the spawned second player and AI snake, the steel and gold of their old tail blueprints. */
+    UPROPERTY(EditDefaultsOnly, Category="Spawning")
+    FLinearColor Player2TailColor = FLinearColor(0.56f, 0.57f, 0.58f);
+
+    UPROPERTY(EditDefaultsOnly, Category="Spawning")
+    FLinearColor AITailColor = FLinearColor(1.0f, 0.77f, 0.34f);
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Level")
     int32 ApplesToFinish = 5;
 
@@ -111,6 +120,18 @@ public:
     UFUNCTION()
     void NotifyAppleEaten(int32 ControllerId);
 
+    /** A snake hit a wall or a body. Ends the game once, however many snakes died. */
+    UFUNCTION()
+    void NotifySnakeDied();
+
+    /**
+     * Bracket one snake step of USnakeTickManagerSubsystem. Game over and the level change
+     * wait for EndSnakeStep, so the rest of the step still plays out on the grid it was
+     * resolved against, and at most one of them is applied.
+     */
+    void BeginSnakeStep();
+    void EndSnakeStep();
+
     UFUNCTION(BlueprintCallable, Category="Game State")
     void SetGameState(EGameState NewState);
 
@@ -126,17 +147,53 @@ public:
     virtual void BeginPlay() override;
     virtual void PostLogin(APlayerController* NewPlayer) override;
     virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
+    /**
+     * Starts a new run in the same frame: scores, snakes (the AI snake included) and the level go
+     * back to their start. The game type carries over until the menu calls SetGameType again.
+     */
     UFUNCTION(BlueprintCallable, Category="Game")
     void RestartGame();
 
+    /** Shows the pooled widget of WidgetClass on top of the open menus and gives it focus. */
+    UFUNCTION(BlueprintCallable, Category="UI")
+    UUserWidget* PushMenu(TSubclassOf<UUserWidget> WidgetClass);
+
+    /** Hides the top menu; focus goes to the one below it, or back to the game. */
+    UFUNCTION(BlueprintCallable, Category="UI")
+    void PopMenu();
+
 protected:
+    // Menus sit above the in-game HUD
+    static constexpr int32 MenuZOrder = 10;
+
+    // One instance per widget class, created on first use and only hidden afterwards
     UPROPERTY()
-    UUserWidget* CurrentWidget;
+    TMap<UClass*, UUserWidget*> WidgetPool;
 
+    // Visible menus, top last
     UPROPERTY()
-    UUserWidget* PauseWidget;
+    TArray<UUserWidget*> MenuStack;
 
 private:
+    UUserWidget* GetPooledWidget(TSubclassOf<UUserWidget> WidgetClass);
+    void FocusMenu(UUserWidget* Widget);
+    void CloseAllMenus();
+
+    bool HasPerPlayerScores() const
+    {
+        return CurrentGameType == EGameType::PvP || CurrentGameType == EGameType::PvAI;
+    }
+
+    /** Pushes the score layout of CurrentGameType to the HUD and every pooled widget. */
+    void ApplyScoreLayout();
+
+    /** Loads the next level, or ends the game after the last one. */
+    void AdvanceLevel();
+    void RefreshScores(UMyUserWidget* Widget) const;
+
+    USnakeActorRegistry* GetRegistry() const;
+    ASnakeWorld* GetSnakeWorld() const;
+
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess="true"))
     EGameState CurrentState = EGameState::MainMenu;
 
@@ -146,6 +203,11 @@ private:
     UPROPERTY()
     ASnakePawn* SpawnedAISnake = nullptr;
     
+    // Outcomes of the snake step in progress, applied by EndSnakeStep
+    bool bInSnakeStep = false;
+    bool bGameOverPending = false;
+    bool bLevelFinishedPending = false;
+
     int32 LevelApplesP1 = 0;
     int32 LevelApplesP2 = 0;
     int32 TotalApplesP1 = 0;
@@ -0,0 +1,102 @@
+#include "SnakeHeadHistory.h"
+
+FSnakeHeadHistory::FSnakeHeadHistory(float InSampleSpacing)
+	: SampleSpacing(FMath::Max(InSampleSpacing, 1.0f))
+{
+	Samples.SetNum(64);
+}
+
+void FSnakeHeadHistory::Reset(const FVector& Position)
+{
+	Start = 0;
+	Count = 0;
+	PushSample(Position);
+	Head = Position;
+	HeadOffset = 0.0f;
+}
+
+void FSnakeHeadHistory::EnsureLength(float MaxDistance)
+{
+	const int32 Needed = FMath::CeilToInt(MaxDistance / SampleSpacing) + 2;
+	if (Needed <= Samples.Num())
+	{
+		return;
+	}
+
+	// Unroll oldest-first into the bigger buffer; only happens when the tail grows
+	TArray<FVector> NewSamples;
+	NewSamples.SetNum(FMath::RoundUpToPowerOfTwo(Needed));
+	for (int32 i = 0; i < Count; ++i)
+	{
+		NewSamples[i] = GetSample(i);
+	}
+	Samples = MoveTemp(NewSamples);
+	Start = 0;
+}
+
+void FSnakeHeadHistory::AddPoint(const FVector& Position)
+{
+	if (Count == 0)
+	{
+		Reset(Position);
+		return;
+	}
+
+	// Walk from the newest sample towards the new head, dropping a sample every SampleSpacing
+	FVector From = GetSample(Count - 1);
+	float Travelled = HeadOffset + FVector::Dist(Head, Position);
+	while (Travelled >= SampleSpacing)
+	{
+		const FVector Dir = (Position - From).GetSafeNormal();
+		if (Dir.IsZero())
+		{
+			break;
+		}
+		From += Dir * SampleSpacing;
+		PushSample(From);
+		Travelled -= SampleSpacing;
+	}
+
+	Head = Position;
+	HeadOffset = FMath::Min(Travelled, SampleSpacing);
+}
+
+FVector FSnakeHeadHistory::Sample(float Distance) const
+{
+	if (Count == 0)
+	{
+		return Head;
+	}
+
+	// Between the head and the newest sample
+	if (Distance <= HeadOffset)
+	{
+		const float Alpha = HeadOffset > 0.0f ? Distance / HeadOffset : 0.0f;
+		return FMath::Lerp(Head, GetSample(Count - 1), Alpha);
+	}
+
+	// Samples are evenly spaced, so the segment containing Distance is a direct index
+	const float Behind = (Distance - HeadOffset) / SampleSpacing;
+	const int32 Steps = FMath::FloorToInt(Behind);
+	const int32 Newer = Count - 1 - Steps;
+	if (Newer <= 0)
+	{
+		return GetSample(0);
+	}
+	return FMath::Lerp(GetSample(Newer), GetSample(Newer - 1), Behind - Steps);
+}
+
+void FSnakeHeadHistory::PushSample(const FVector& Position)
+{
+	const int32 Mask = Samples.Num() - 1;
+	if (Count < Samples.Num())
+	{
+		Samples[(Start + Count) & Mask] = Position;
+		++Count;
+	}
+	else
+	{
+		Samples[Start] = Position;
+		Start = (Start + 1) & Mask;
+	}
+}
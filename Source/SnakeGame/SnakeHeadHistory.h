@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Path the head has travelled, stored as points spaced evenly by distance in a ring buffer.
+ * The spacing does not depend on the frame rate, so looking up "the point N units behind the
+ * head" gives the same tail shape at any fps, and dropping old points costs nothing.
+ */
+class SNAKEGAME_API FSnakeHeadHistory
+{
+public:
+	explicit FSnakeHeadHistory(float InSampleSpacing = 10.0f);
+
+	/** Clears the history and starts a new path at Position. */
+	void Reset(const FVector& Position);
+
+	/** Makes sure at least MaxDistance of path behind the head is kept. */
+	void EnsureLength(float MaxDistance);
+
+	/** Extends the path to the current head position. */
+	void AddPoint(const FVector& Position);
+
+	/** Point on the path Distance units behind the head; clamps to the oldest recorded point. */
+	FVector Sample(float Distance) const;
+
+	bool IsEmpty() const { return Count == 0; }
+
+private:
+	const FVector& GetSample(int32 Index) const
+	{
+		// Index 0 is the oldest sample still in the buffer
+		return Samples[(Start + Index) & (Samples.Num() - 1)];
+	}
+
+	void PushSample(const FVector& Position);
+
+	float SampleSpacing;
+
+	// Capacity is a power of two, the oldest sample is overwritten once full
+	TArray<FVector> Samples;
+	int32 Start = 0;
+	int32 Count = 0;
+
+	// Head position and how far past the newest sample it is
+	FVector Head = FVector::ZeroVector;
+	float HeadOffset = 0.0f;
+};
@@ -0,0 +1,42 @@
+#include "SnakeLevelCookCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "SnakeLevelData.h"
+
+USnakeLevelCookCommandlet::USnakeLevelCookCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 USnakeLevelCookCommandlet::Main(const FString& Params)
+{
+	const FString LevelDir = FPaths::ProjectContentDir() / TEXT("Levels");
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(LevelDir / TEXT("Level*.txt")), true, false);
+
+	int32 NumFailed = 0;
+	for (const FString& File : Files)
+	{
+		const FString SourcePath = LevelDir / File;
+		const FString CookedPath = FPaths::ChangeExtension(SourcePath, TEXT("snklvl"));
+
+		FSnakeLevelData Level;
+		if (!FSnakeLevelData::LoadText(SourcePath, Level) || !Level.SaveCooked(CookedPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LevelCook] Failed to cook %s"), *SourcePath);
+			++NumFailed;
+			continue;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("[LevelCook] %s -> %s (%dx%d, %d floor, %d spawn)"),
+			*File, *FPaths::GetCleanFilename(CookedPath),
+			Level.Width, Level.Height, Level.FloorCells.Num(), Level.SpawnCells.Num());
+	}
+
+	return NumFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SnakeLevelCookCommandlet.generated.h"
+
+/**
+ * Converts every Content/Levels/LevelN.txt into the binary LevelN.snklvl read by FSnakeLevelData.
+ * Run with: UnrealEditor-Cmd SnakeGame.uproject -run=SnakeLevelCook
+ */
+UCLASS()
+class SNAKEGAME_API USnakeLevelCookCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USnakeLevelCookCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,381 @@
+#include "SnakeLevelData.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace SnakeLevelFile
+{
+	static constexpr uint32 Magic = 0x4C4B4E53; // "SNKL"
+	static constexpr uint32 Version = 1;
+
+	// Far beyond any arena, but keeps every cell index and plane size well inside 32 bits
+	static constexpr int64 MaxCells = 1 << 24;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 Width;
+		int32 Height;
+		int32 NumFloorCells;
+		int32 NumSpawnCells;
+		int32 NumDoorCells;
+		int32 Reserved;
+	};
+	static_assert(sizeof(FHeader) == 32, "Header must stay 8-byte aligned so the planes can be read in place");
+
+	// Bit planes are row aligned: each row starts on a new 64-bit word
+	static int32 GetWordsPerRow(int32 Width)
+	{
+		return (Width + 63) / 64;
+	}
+
+	static int64 GetExpectedSize(const FHeader& Header)
+	{
+		const int64 PlaneWords = int64(GetWordsPerRow(Header.Width)) * Header.Height;
+		const int64 NumIndices = int64(Header.NumFloorCells) + Header.NumSpawnCells + Header.NumDoorCells;
+		return sizeof(FHeader) + 3 * PlaneWords * sizeof(uint64) + NumIndices * sizeof(uint32);
+	}
+}
+
+void FSnakeLevelData::BuildCellLists()
+{
+	FloorCells.Reset();
+	SpawnCells.Reset();
+	DoorCells.Reset();
+
+	WordsPerRow = SnakeLevelFile::GetWordsPerRow(Width);
+	TArray<uint64> FloorRows;
+	FloorRows.SetNumZeroed(WordsPerRow * Height);
+
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			switch (Cells[Y * Width + X])
+			{
+			case ESnakeCell::Floor:
+				FloorCells.Add(FIntPoint(X, Y));
+				FloorRows[Y * WordsPerRow + X / 64] |= uint64(1) << (X % 64);
+				break;
+
+			case ESnakeCell::Door:
+				DoorCells.Add(FIntPoint(X, Y));
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+
+	BuildInteriorMask(FloorRows.GetData(), Width, Height, InteriorMask);
+
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 W = 0; W < WordsPerRow; ++W)
+		{
+			uint64 Bits = InteriorMask[Y * WordsPerRow + W];
+			while (Bits)
+			{
+				SpawnCells.Add(FIntPoint(W * 64 + int32(FMath::CountTrailingZeros64(Bits)), Y));
+				Bits &= Bits - 1;
+			}
+		}
+	}
+}
+
+void FSnakeLevelData::BuildInteriorMask(const uint64* FloorRows, int32 InWidth, int32 InHeight, TArray<uint64>& OutMask)
+{
+	const int32 Words = SnakeLevelFile::GetWordsPerRow(InWidth);
+	OutMask.SetNumZeroed(Words * InHeight);
+
+	// The first and last rows have no row beyond them, so they can never be interior
+	for (int32 Y = 1; Y < InHeight - 1; ++Y)
+	{
+		const uint64* Above = FloorRows + (Y - 1) * Words;
+		const uint64* Row = FloorRows + Y * Words;
+		const uint64* Below = FloorRows + (Y + 1) * Words;
+		uint64* Out = OutMask.GetData() + Y * Words;
+
+		for (int32 W = 0; W < Words; ++W)
+		{
+			// Bits carried across word boundaries; columns past the row ends read as void
+			const uint64 Prev = W > 0 ? Row[W - 1] : 0;
+			const uint64 Next = W + 1 < Words ? Row[W + 1] : 0;
+			const uint64 LeftIsFloor = (Row[W] << 1) | (Prev >> 63);
+			const uint64 RightIsFloor = (Row[W] >> 1) | (Next << 63);
+
+			Out[W] = Row[W] & LeftIsFloor & RightIsFloor & Above[W] & Below[W];
+		}
+	}
+}
+
+FString FSnakeLevelData::GetTextPath(int32 LevelIndex)
+{
+	return FPaths::ProjectContentDir() / FString::Printf(TEXT("Levels/Level%d.txt"), LevelIndex);
+}
+
+FString FSnakeLevelData::GetCookedPath(int32 LevelIndex)
+{
+	return FPaths::ProjectContentDir() / FString::Printf(TEXT("Levels/Level%d.snklvl"), LevelIndex);
+}
+
+bool FSnakeLevelData::Exists(int32 LevelIndex)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	return PlatformFile.FileExists(*GetCookedPath(LevelIndex))
+		|| PlatformFile.FileExists(*GetTextPath(LevelIndex));
+}
+
+bool FSnakeLevelData::Load(int32 LevelIndex, FSnakeLevelData& OutLevel)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString CookedPath = GetCookedPath(LevelIndex);
+	const FString TextPath = GetTextPath(LevelIndex);
+
+	// MinValue for a missing file, so a build that ships only the cooked levels always uses them
+	const FDateTime CookedTime = PlatformFile.GetTimeStamp(*CookedPath);
+	if (CookedTime != FDateTime::MinValue())
+	{
+		if (CookedTime < PlatformFile.GetTimeStamp(*TextPath))
+		{
+			UE_LOG(LogTemp, Log, TEXT("[LevelLoad] %s was edited after it was cooked, loading the text."), *TextPath);
+		}
+		else if (LoadCooked(CookedPath, OutLevel))
+		{
+			return true;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LevelLoad] Cooked level %s is invalid, falling back to text."), *CookedPath);
+		}
+	}
+	return LoadText(TextPath, OutLevel);
+}
+
+bool FSnakeLevelData::LoadText(const FString& Path, FSnakeLevelData& OutLevel)
+{
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *Path))
+	{
+		return false;
+	}
+	return ParseText(Text, OutLevel);
+}
+
+bool FSnakeLevelData::ParseText(const FString& Text, FSnakeLevelData& OutLevel)
+{
+	// Find the line spans first so the grid can be sized once; empty lines are skipped
+	// like LoadFileToStringArray used to
+	TArray<TPair<int32, int32>, TInlineAllocator<256>> Lines;
+	int32 MaxWidth = 0;
+	int32 LineStart = 0;
+	const int32 Len = Text.Len();
+	for (int32 i = 0; i <= Len; ++i)
+	{
+		if (i == Len || Text[i] == TEXT('\n'))
+		{
+			int32 LineEnd = i;
+			if (LineEnd > LineStart && Text[LineEnd - 1] == TEXT('\r'))
+			{
+				--LineEnd;
+			}
+			if (LineEnd > LineStart)
+			{
+				Lines.Emplace(LineStart, LineEnd - LineStart);
+				MaxWidth = FMath::Max(MaxWidth, LineEnd - LineStart);
+			}
+			LineStart = i + 1;
+		}
+	}
+
+	OutLevel.Width = MaxWidth;
+	OutLevel.Height = Lines.Num();
+	OutLevel.Cells.Init(ESnakeCell::Void, OutLevel.Width * OutLevel.Height);
+
+	for (int32 Y = 0; Y < Lines.Num(); ++Y)
+	{
+		const TCHAR* Line = *Text + Lines[Y].Key;
+		ESnakeCell* Row = OutLevel.Cells.GetData() + Y * OutLevel.Width;
+		for (int32 X = 0; X < Lines[Y].Value; ++X)
+		{
+			switch (Line[X])
+			{
+			case '#': Row[X] = ESnakeCell::Wall;  break;
+			case '.': Row[X] = ESnakeCell::Floor; break;
+			case 'D': Row[X] = ESnakeCell::Door;  break;
+			default:  break;
+			}
+		}
+	}
+
+	OutLevel.BuildCellLists();
+	return OutLevel.IsValid();
+}
+
+bool FSnakeLevelData::LoadCooked(const FString& Path, FSnakeLevelData& OutLevel)
+{
+	// Map the file instead of copying it; the planes are decoded straight from the mapping
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IMappedFileHandle> Handle(PlatformFile.OpenMapped(*Path));
+	if (Handle)
+	{
+		TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion(0, Handle->GetFileSize()));
+		if (Region)
+		{
+			return ParseCooked(Region->GetMappedPtr(), Region->GetMappedSize(), OutLevel);
+		}
+	}
+
+	// Platforms without mapping support (or files inside a pak) take the plain read
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+	{
+		return false;
+	}
+	return ParseCooked(Bytes.GetData(), Bytes.Num(), OutLevel);
+}
+
+bool FSnakeLevelData::ParseCooked(const uint8* Data, int64 Size, FSnakeLevelData& OutLevel)
+{
+	using namespace SnakeLevelFile;
+
+	if (!Data || Size < int64(sizeof(FHeader)))
+	{
+		return false;
+	}
+
+	FHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof(FHeader));
+	if (Header.Magic != Magic || Header.Version != Version
+		|| Header.Width <= 0 || Header.Height <= 0
+		|| int64(Header.Width) * Header.Height > MaxCells
+		|| Header.NumFloorCells < 0 || Header.NumSpawnCells < 0 || Header.NumDoorCells < 0
+		|| GetExpectedSize(Header) != Size)
+	{
+		return false;
+	}
+
+	OutLevel.Width = Header.Width;
+	OutLevel.Height = Header.Height;
+	OutLevel.Cells.Init(ESnakeCell::Void, Header.Width * Header.Height);
+
+	const int32 WordsPerRow = GetWordsPerRow(Header.Width);
+	const int64 PlaneWords = int64(WordsPerRow) * Header.Height;
+	const uint64* Planes = reinterpret_cast<const uint64*>(Data + sizeof(FHeader));
+
+	// Plane order matches SaveCooked; only set bits are visited
+	static const ESnakeCell PlaneCells[3] = { ESnakeCell::Wall, ESnakeCell::Floor, ESnakeCell::Door };
+	for (int32 Plane = 0; Plane < 3; ++Plane)
+	{
+		const uint64* Words = Planes + Plane * PlaneWords;
+		for (int32 Y = 0; Y < Header.Height; ++Y)
+		{
+			ESnakeCell* Row = OutLevel.Cells.GetData() + Y * Header.Width;
+			for (int32 W = 0; W < WordsPerRow; ++W)
+			{
+				uint64 Bits = Words[Y * WordsPerRow + W];
+				while (Bits)
+				{
+					const int32 X = W * 64 + int32(FMath::CountTrailingZeros64(Bits));
+					if (X < Header.Width)
+					{
+						Row[X] = PlaneCells[Plane];
+					}
+					Bits &= Bits - 1;
+				}
+			}
+		}
+	}
+
+	// The floor plane already has the mask layout, so the interior test runs on the mapping directly
+	OutLevel.WordsPerRow = WordsPerRow;
+	BuildInteriorMask(Planes + PlaneWords, Header.Width, Header.Height, OutLevel.InteriorMask);
+
+	const uint32* Indices = reinterpret_cast<const uint32*>(Planes + 3 * PlaneWords);
+	const uint32 Width = uint32(Header.Width);
+	const uint32 NumCells = Width * uint32(Header.Height);
+	auto ReadList = [&Indices, Width, NumCells](int32 Num, TArray<FIntPoint>& OutList)
+	{
+		OutList.SetNumUninitialized(Num);
+		for (int32 i = 0; i < Num; ++i)
+		{
+			if (Indices[i] >= NumCells)
+			{
+				return false;
+			}
+			OutList[i] = FIntPoint(int32(Indices[i] % Width), int32(Indices[i] / Width));
+		}
+		Indices += Num;
+		return true;
+	};
+
+	return ReadList(Header.NumFloorCells, OutLevel.FloorCells)
+		&& ReadList(Header.NumSpawnCells, OutLevel.SpawnCells)
+		&& ReadList(Header.NumDoorCells, OutLevel.DoorCells);
+}
+
+bool FSnakeLevelData::SaveCooked(const FString& Path) const
+{
+	using namespace SnakeLevelFile;
+
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	FHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.Width = Width;
+	Header.Height = Height;
+	Header.NumFloorCells = FloorCells.Num();
+	Header.NumSpawnCells = SpawnCells.Num();
+	Header.NumDoorCells = DoorCells.Num();
+	Header.Reserved = 0;
+
+	const int32 WordsPerRow = GetWordsPerRow(Width);
+	const int32 PlaneWords = WordsPerRow * Height;
+
+	TArray<uint64> Planes;
+	Planes.SetNumZeroed(3 * PlaneWords);
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			int32 Plane = INDEX_NONE;
+			switch (Cells[Y * Width + X])
+			{
+			case ESnakeCell::Wall:  Plane = 0; break;
+			case ESnakeCell::Floor: Plane = 1; break;
+			case ESnakeCell::Door:  Plane = 2; break;
+			default: break;
+			}
+			if (Plane != INDEX_NONE)
+			{
+				Planes[Plane * PlaneWords + Y * WordsPerRow + X / 64] |= uint64(1) << (X % 64);
+			}
+		}
+	}
+
+	TArray<uint32> Indices;
+	Indices.Reserve(FloorCells.Num() + SpawnCells.Num() + DoorCells.Num());
+	for (const TArray<FIntPoint>* List : { &FloorCells, &SpawnCells, &DoorCells })
+	{
+		for (const FIntPoint& Cell : *List)
+		{
+			Indices.Add(uint32(Cell.Y * Width + Cell.X));
+		}
+	}
+
+	TArray<uint8> Bytes;
+	Bytes.Reserve(int32(GetExpectedSize(Header)));
+	Bytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FHeader));
+	Bytes.Append(reinterpret_cast<const uint8*>(Planes.GetData()), Planes.Num() * sizeof(uint64));
+	Bytes.Append(reinterpret_cast<const uint8*>(Indices.GetData()), Indices.Num() * sizeof(uint32));
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Static content of a grid cell, as read from the level file. */
+enum class ESnakeCell : uint8
+{
+	Void,   // 'O' or past the end of a line
+	Floor,  // '.'
+	Wall,   // '#'
+	Door    // 'D'
+};
+
+/**
+ * A parsed level: the cell grid plus the lists every consumer needs, built once at load.
+ *
+ * Levels are authored as Content/Levels/LevelN.txt. The SnakeLevelCook commandlet turns them into
+ * LevelN.snklvl next to the text file: a fixed header, one bit plane per cell type and the
+ * precomputed lists. Load() memory-maps the cooked file when it exists and is not older than the
+ * text, and only parses the text otherwise.
+ */
+struct SNAKEGAME_API FSnakeLevelData
+{
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// Row-major, Height rows of Width cells; row 0 is the first line of the file
+	TArray<ESnakeCell> Cells;
+
+	TArray<FIntPoint> FloorCells;
+
+	// Floor cells food may spawn on (floor on all four sides)
+	TArray<FIntPoint> SpawnCells;
+
+	TArray<FIntPoint> DoorCells;
+
+	// One bit per cell, set for floor cells with floor on all four sides. Rows start on a new
+	// 64-bit word, bit X % 64 of word X / 64 is column X.
+	TArray<uint64> InteriorMask;
+	int32 WordsPerRow = 0;
+
+	bool IsInterior(int32 X, int32 Y) const
+	{
+		return X >= 0 && Y >= 0 && X < Width && Y < Height
+			&& (InteriorMask[Y * WordsPerRow + X / 64] >> (X % 64)) & 1;
+	}
+
+	bool IsValid() const { return Width > 0 && Height > 0 && Cells.Num() == Width * Height; }
+
+	ESnakeCell GetCell(int32 X, int32 Y) const
+	{
+		return (X >= 0 && Y >= 0 && X < Width && Y < Height) ? Cells[Y * Width + X] : ESnakeCell::Void;
+	}
+
+	/** Rebuilds FloorCells, SpawnCells, DoorCells and InteriorMask from Cells. */
+	void BuildCellLists();
+
+	/**
+	 * Interior test for a whole level at once: a row of floor bits ANDed with itself shifted one
+	 * column each way and with the rows above and below. FloorRows uses the InteriorMask layout.
+	 */
+	static void BuildInteriorMask(const uint64* FloorRows, int32 InWidth, int32 InHeight, TArray<uint64>& OutMask);
+
+	static FString GetTextPath(int32 LevelIndex);
+	static FString GetCookedPath(int32 LevelIndex);
+	static bool Exists(int32 LevelIndex);
+
+	/** Loads the cooked level when present and up to date, and falls back to the text source. */
+	static bool Load(int32 LevelIndex, FSnakeLevelData& OutLevel);
+
+	static bool LoadText(const FString& Path, FSnakeLevelData& OutLevel);
+	static bool ParseText(const FString& Text, FSnakeLevelData& OutLevel);
+
+	static bool LoadCooked(const FString& Path, FSnakeLevelData& OutLevel);
+	static bool ParseCooked(const uint8* Data, int64 Size, FSnakeLevelData& OutLevel);
+	bool SaveCooked(const FString& Path) const;
+};
@@ -0,0 +1,232 @@
+#include "SnakePathBenchmarkCommandlet.h"
+
+#include <queue>
+
+#include "Definitions.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "SnakeLevelData.h"
+#include "SnakePathfinder.h"
+#include "SnakeSimulation.h"
+
+namespace
+{
+	/**
+	 * ASnakeAIController::FindPath as it was before FSnakePathfinder, kept as the baseline:
+	 * breadth-first over world positions with a TSet of floor tiles rebuilt on every call and
+	 * a TMap of parents. The benchmark has no snake bodies, so the body set it built is empty.
+	 */
+	bool FindPathOriginalBfs(const TArray<FVector>& FloorTileLocations, const FVector& Start, const FVector& Goal, TArray<FVector>& OutPath)
+	{
+		TSet<FVector> Walkable(FloorTileLocations);
+		TSet<FVector> BodyTiles;
+		if (!Walkable.Contains(Goal)) return false;
+
+		std::queue<FVector> Q;
+		Q.push(Start);
+		TMap<FVector, FVector> CameFrom;
+		CameFrom.Add(Start, Start);
+
+		static const TArray<FVector> Directions = {
+			FVector(TileSize, 0, 0),
+			FVector(-TileSize, 0, 0),
+			FVector(0, TileSize, 0),
+			FVector(0, -TileSize, 0)
+		};
+
+		while (!Q.empty())
+		{
+			FVector Curr = Q.front(); Q.pop();
+			if (Curr == Goal) break;
+
+			for (const FVector& Dir : Directions)
+			{
+				FVector Next = Curr + Dir;
+				if (!Walkable.Contains(Next)
+				 || CameFrom.Contains(Next)
+				 || BodyTiles.Contains(Next))
+				{
+					continue;
+				}
+				CameFrom.Add(Next, Curr);
+				Q.push(Next);
+			}
+		}
+
+		if (!CameFrom.Contains(Goal))
+			return false;
+
+		TArray<FVector> ReversePath;
+		for (FVector At = Goal; At != Start; At = CameFrom[At])
+			ReversePath.Add(At);
+		ReversePath.Add(Start);
+
+		for (int32 i = ReversePath.Num() - 1; i >= 0; --i)
+			OutPath.Add(ReversePath[i]);
+
+		return true;
+	}
+
+	FVector CellToLocation(const FIntPoint& Cell)
+	{
+		return FVector(Cell.X * TileSize, Cell.Y * TileSize, 0.0f);
+	}
+}
+
+USnakePathBenchmarkCommandlet::USnakePathBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 USnakePathBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumQueries = 200;
+	int32 ArenaSize = 1024;
+	FParse::Value(*Params, TEXT("Queries="), NumQueries);
+	FParse::Value(*Params, TEXT("ArenaSize="), ArenaSize);
+	NumQueries = FMath::Max(NumQueries, 1);
+
+	const FString LevelDir = FPaths::ProjectContentDir() / TEXT("Levels");
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(LevelDir / TEXT("Level*.txt")), true, false);
+	Files.Sort();
+
+	bool bAllMatched = true;
+	for (const FString& File : Files)
+	{
+		FSnakeLevelData Level;
+		if (!FSnakeLevelData::LoadText(LevelDir / File, Level))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[PathBench] Failed to load %s"), *File);
+			continue;
+		}
+		bAllMatched &= RunBenchmark(File, Level, NumQueries);
+	}
+
+	if (ArenaSize > 2)
+	{
+		FSnakeLevelData Arena;
+		MakeArena(ArenaSize, Arena);
+		bAllMatched &= RunBenchmark(FString::Printf(TEXT("Arena%dx%d"), ArenaSize, ArenaSize), Arena, NumQueries);
+	}
+
+	return bAllMatched ? 0 : 1;
+}
+
+bool USnakePathBenchmarkCommandlet::RunBenchmark(const FString& Name, const FSnakeLevelData& Level, int32 NumQueries)
+{
+	if (Level.FloorCells.Num() < 2)
+	{
+		return true;
+	}
+
+	FSnakeSimulation Sim;
+	Sim.SetGrid(Level);
+
+	// Same queries for every algorithm
+	FRandomStream Random(1234);
+	TArray<TPair<FIntPoint, FIntPoint>> Queries;
+	Queries.Reserve(NumQueries);
+	for (int32 i = 0; i < NumQueries; ++i)
+	{
+		const FIntPoint Start = Level.FloorCells[Random.RandRange(0, Level.FloorCells.Num() - 1)];
+		const FIntPoint Goal = Level.FloorCells[Random.RandRange(0, Level.FloorCells.Num() - 1)];
+		Queries.Emplace(Start, Goal);
+	}
+
+	// The AI's original search, fed the same floor tiles ASnakeWorld::FloorTileLocations held
+	TArray<FVector> FloorTileLocations;
+	FloorTileLocations.Reserve(Level.FloorCells.Num());
+	for (const FIntPoint& Cell : Level.FloorCells)
+	{
+		FloorTileLocations.Add(CellToLocation(Cell));
+	}
+
+	TArray<FVector> BfsPath;
+	double StartTime = FPlatformTime::Seconds();
+	for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+	{
+		BfsPath.Reset();
+		FindPathOriginalBfs(FloorTileLocations, CellToLocation(Query.Key), CellToLocation(Query.Value), BfsPath);
+	}
+	const double BfsSeconds = FPlatformTime::Seconds() - StartTime;
+
+	FSnakePathfinder Pathfinder;
+	TArray<FIntPoint> Path;
+	TArray<int32> Lengths;
+	Lengths.Reserve(NumQueries);
+
+	int64 AStarExpanded = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+	{
+		Lengths.Add(Pathfinder.FindPath(Sim, Query.Key, Query.Value, Path, ESnakePathAlgorithm::AStar) ? Path.Num() : 0);
+		AStarExpanded += Pathfinder.GetLastExpandedCount();
+	}
+	const double AStarSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int64 JumpExpanded = 0;
+	int32 NumMismatched = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Queries.Num(); ++i)
+	{
+		const int32 Length = Pathfinder.FindPath(Sim, Queries[i].Key, Queries[i].Value, Path, ESnakePathAlgorithm::JumpPoint) ? Path.Num() : 0;
+		JumpExpanded += Pathfinder.GetLastExpandedCount();
+		NumMismatched += Length != Lengths[i];
+	}
+	const double JumpSeconds = FPlatformTime::Seconds() - StartTime;
+
+	const double ToMicroseconds = 1e6 / Queries.Num();
+	UE_LOG(LogTemp, Display, TEXT("[PathBench] %s (%dx%d, %d queries)"), *Name, Level.Width, Level.Height, Queries.Num());
+	UE_LOG(LogTemp, Display, TEXT("[PathBench]   BFS  %10.1f us/query (original AI search)"), BfsSeconds * ToMicroseconds);
+	UE_LOG(LogTemp, Display, TEXT("[PathBench]   A*   %10.1f us/query %10lld expanded"), AStarSeconds * ToMicroseconds, AStarExpanded / Queries.Num());
+	UE_LOG(LogTemp, Display, TEXT("[PathBench]   JPS  %10.1f us/query %10lld expanded"), JumpSeconds * ToMicroseconds, JumpExpanded / Queries.Num());
+
+	if (NumMismatched > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[PathBench]   %d JPS paths differ in length from A*"), NumMismatched);
+	}
+	return NumMismatched == 0;
+}
+
+void USnakePathBenchmarkCommandlet::MakeArena(int32 Size, FSnakeLevelData& OutLevel)
+{
+	OutLevel.Width = Size;
+	OutLevel.Height = Size;
+	OutLevel.Cells.Init(ESnakeCell::Floor, Size * Size);
+
+	for (int32 i = 0; i < Size; ++i)
+	{
+		OutLevel.Cells[i] = ESnakeCell::Wall;
+		OutLevel.Cells[(Size - 1) * Size + i] = ESnakeCell::Wall;
+		OutLevel.Cells[i * Size] = ESnakeCell::Wall;
+		OutLevel.Cells[i * Size + Size - 1] = ESnakeCell::Wall;
+	}
+
+	// A few blocks so the searches have something to go around
+	FRandomStream Random(Size);
+	const int32 NumBlocks = Size / 16;
+	const int32 MaxBlockSize = FMath::Max(Size / 32, 2);
+	for (int32 Block = 0; Block < NumBlocks; ++Block)
+	{
+		const int32 BlockWidth = Random.RandRange(1, MaxBlockSize);
+		const int32 BlockHeight = Random.RandRange(1, MaxBlockSize);
+		const int32 Left = Random.RandRange(1, FMath::Max(Size - 1 - BlockWidth, 1));
+		const int32 Top = Random.RandRange(1, FMath::Max(Size - 1 - BlockHeight, 1));
+		for (int32 Y = Top; Y < FMath::Min(Top + BlockHeight, Size - 1); ++Y)
+		{
+			for (int32 X = Left; X < FMath::Min(Left + BlockWidth, Size - 1); ++X)
+			{
+				OutLevel.Cells[Y * Size + X] = ESnakeCell::Wall;
+			}
+		}
+	}
+
+	OutLevel.BuildCellLists();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SnakePathBenchmarkCommandlet.generated.h"
+
+struct FSnakeLevelData;
+
+/**
+ * Times the AI path searches on every Content/Levels/LevelN.txt and on a generated open arena:
+ * the AI controller's original breadth-first search, A* and Jump Point Search over the same random
+ * queries.
+ * Run with: UnrealEditor-Cmd SnakeGame.uproject -run=SnakePathBenchmark [-Queries=200] [-ArenaSize=1024]
+ */
+UCLASS()
+class SNAKEGAME_API USnakePathBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USnakePathBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Logs one line per algorithm; returns false if JPS and A* disagree on a path length. */
+	static bool RunBenchmark(const FString& Name, const FSnakeLevelData& Level, int32 NumQueries);
+
+	/** Square level with a wall border and a few rectangular blocks, mostly open floor. */
+	static void MakeArena(int32 Size, FSnakeLevelData& OutLevel);
+};
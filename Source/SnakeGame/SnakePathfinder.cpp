@@ -0,0 +1,328 @@
+#include "SnakePathfinder.h"
+
+#include "Algo/Reverse.h"
+
+namespace
+{
+	// Lowest F first; on ties prefer the node further from the start, which keeps A* from
+	// fanning out over open floor when many paths are equally short
+	struct FOpenNodeLess
+	{
+		template <typename NodeType>
+		bool operator()(const NodeType& A, const NodeType& B) const
+		{
+			return A.F < B.F || (A.F == B.F && A.G > B.G);
+		}
+	};
+
+	int32 ManhattanDistance(int32 Width, int32 Index, const FIntPoint& Goal)
+	{
+		return FMath::Abs(Index % Width - Goal.X) + FMath::Abs(Index / Width - Goal.Y);
+	}
+}
+
+void FSnakePathfinder::BeginSearch(int32 NumCells)
+{
+	if (Visited.Num() != NumCells)
+	{
+		Parent.SetNumUninitialized(NumCells);
+		Cost.SetNumUninitialized(NumCells);
+		Visited.SetNumZeroed(NumCells);
+		BodyStamp.SetNumZeroed(NumCells);
+		RunStop.SetNumUninitialized(NumCells * 2);
+		RunStamp.SetNumZeroed(NumCells * 2);
+		Generation = 0;
+	}
+
+	// Stamps only need clearing when the counter wraps
+	if (++Generation == 0)
+	{
+		FMemory::Memzero(Visited.GetData(), Visited.Num() * sizeof(uint32));
+		FMemory::Memzero(BodyStamp.GetData(), BodyStamp.Num() * sizeof(uint32));
+		FMemory::Memzero(RunStamp.GetData(), RunStamp.Num() * sizeof(uint32));
+		Generation = 1;
+	}
+
+	Open.Reset();
+	LastExpandedCount = 0;
+}
+
+bool FSnakePathfinder::FindPath(const FSnakeSimulation& Sim, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath,
+	ESnakePathAlgorithm Algorithm)
+{
+	OutPath.Reset();
+	if (!Sim.IsInBounds(Start) || !Sim.IsInBounds(Goal) || !Sim.IsWalkable(Goal) || Sim.IsBlocked(Goal))
+	{
+		return false;
+	}
+
+	const TArray<FSnakeGridCell>& Cells = Sim.GetGridCells();
+	BeginSearch(Cells.Num());
+
+	auto IsOpen = [&Cells](int32 Index)
+	{
+		const FSnakeGridCell& Cell = Cells[Index];
+		return (Cell.Terrain == ESnakeCell::Floor || Cell.Terrain == ESnakeCell::Door)
+			&& Cell.Occupant != ESnakeOccupant::Body;
+	};
+
+	return Algorithm == ESnakePathAlgorithm::JumpPoint
+		? SearchJumpPoint(Sim.GetWidth(), Sim.GetHeight(), Start, Goal, OutPath, IsOpen)
+		: Search(Sim.GetWidth(), Sim.GetHeight(), Start, Goal, OutPath, IsOpen);
+}
+
+bool FSnakePathfinder::FindPath(const FSnakeGridSnapshot& Snapshot, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath,
+	ESnakePathAlgorithm Algorithm)
+{
+	OutPath.Reset();
+	const int32 Width = Snapshot.Width;
+	const int32 Height = Snapshot.Height;
+	auto InBounds = [Width, Height](const FIntPoint& Cell)
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	};
+	if (!Snapshot.Terrain.IsValid() || !InBounds(Start) || !InBounds(Goal))
+	{
+		return false;
+	}
+
+	const TArray<ESnakeCell>& Terrain = *Snapshot.Terrain;
+	BeginSearch(Terrain.Num());
+
+	// Stamp the bodies with this search's generation instead of copying the grid
+	for (const int32 BodyIndex : Snapshot.BodyCells)
+	{
+		BodyStamp[BodyIndex] = Generation;
+	}
+
+	auto IsOpen = [this, &Terrain](int32 Index)
+	{
+		return (Terrain[Index] == ESnakeCell::Floor || Terrain[Index] == ESnakeCell::Door)
+			&& BodyStamp[Index] != Generation;
+	};
+	if (!IsOpen(Goal.Y * Width + Goal.X))
+	{
+		return false;
+	}
+
+	return Algorithm == ESnakePathAlgorithm::JumpPoint
+		? SearchJumpPoint(Width, Height, Start, Goal, OutPath, IsOpen)
+		: Search(Width, Height, Start, Goal, OutPath, IsOpen);
+}
+
+template <typename IsOpenFn>
+bool FSnakePathfinder::Search(int32 Width, int32 Height, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath, IsOpenFn IsOpen)
+{
+	const int32 StartIndex = Start.Y * Width + Start.X;
+	const int32 GoalIndex = Goal.Y * Width + Goal.X;
+
+	Visited[StartIndex] = Generation;
+	Parent[StartIndex] = StartIndex;
+	Cost[StartIndex] = 0;
+	Open.HeapPush(FOpenNode{ ManhattanDistance(Width, StartIndex, Goal), 0, StartIndex }, FOpenNodeLess());
+
+	while (Open.Num() > 0)
+	{
+		FOpenNode Node;
+		Open.HeapPop(Node, FOpenNodeLess(), EAllowShrinking::No);
+
+		// Stale entry, a cheaper route to this cell was queued after it
+		if (Node.G > Cost[Node.Index])
+		{
+			continue;
+		}
+		++LastExpandedCount;
+
+		if (Node.Index == GoalIndex)
+		{
+			BuildPath(Width, StartIndex, GoalIndex, OutPath);
+			return true;
+		}
+
+		const int32 X = Node.Index % Width;
+		const int32 Y = Node.Index / Width;
+		const int32 Neighbours[4] = {
+			Y > 0          ? Node.Index - Width : INDEX_NONE,
+			X < Width - 1  ? Node.Index + 1     : INDEX_NONE,
+			Y < Height - 1 ? Node.Index + Width : INDEX_NONE,
+			X > 0          ? Node.Index - 1     : INDEX_NONE
+		};
+
+		for (const int32 Next : Neighbours)
+		{
+			if (Next == INDEX_NONE)
+			{
+				continue;
+			}
+
+			if (!IsOpen(Next))
+			{
+				continue;
+			}
+
+			const int32 G = Node.G + 1;
+			if (IsVisited(Next) && Cost[Next] <= G)
+			{
+				continue;
+			}
+
+			Visited[Next] = Generation;
+			Parent[Next] = Node.Index;
+			Cost[Next] = G;
+			Open.HeapPush(FOpenNode{ G + ManhattanDistance(Width, Next, Goal), G, Next }, FOpenNodeLess());
+		}
+	}
+
+	return false;
+}
+
+template <typename IsOpenFn>
+bool FSnakePathfinder::SearchJumpPoint(int32 Width, int32 Height, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath, IsOpenFn IsOpen)
+{
+	const int32 StartIndex = Start.Y * Width + Start.X;
+	const int32 GoalIndex = Goal.Y * Width + Goal.X;
+
+	auto IsFree = [Width, Height, &IsOpen](int32 X, int32 Y)
+	{
+		return X >= 0 && Y >= 0 && X < Width && Y < Height && IsOpen(Y * Width + X);
+	};
+
+	// A horizontal run stops where a cell above or below opens up that was walled one step back,
+	// since the shortest way there turns at this cell. Every cell a run passes leads to the same
+	// stop, so it is remembered for all of them: each vertical run looks along every row it
+	// crosses, and without this the same rows were scanned again for every jump.
+	auto JumpHorizontal = [this, &IsFree, Width, GoalIndex](int32 X, int32 Y, int32 DX)
+	{
+		const int32 Side = DX > 0 ? 1 : 0;
+		int32 Stop = INDEX_NONE;
+		int32 At = X;
+		for (; IsFree(At, Y); At += DX)
+		{
+			const int32 Index = Y * Width + At;
+			if (RunStamp[Index * 2 + Side] == Generation)
+			{
+				Stop = RunStop[Index * 2 + Side];
+				break;
+			}
+			if (Index == GoalIndex
+				|| (IsFree(At, Y - 1) && !IsFree(At - DX, Y - 1))
+				|| (IsFree(At, Y + 1) && !IsFree(At - DX, Y + 1)))
+			{
+				Stop = Index;
+				At += DX;
+				break;
+			}
+		}
+
+		for (int32 Passed = X; Passed != At; Passed += DX)
+		{
+			const int32 Index = Y * Width + Passed;
+			RunStamp[Index * 2 + Side] = Generation;
+			RunStop[Index * 2 + Side] = Stop;
+		}
+		return Stop;
+	};
+
+	// Vertical runs also stop wherever a horizontal run from them would find a jump point, so
+	// the search only ever turns at jump points. This is what keeps the paths shortest on a
+	// 4-connected grid: a purely local forced-neighbour test misses turns lined up with a corner
+	// further along the row, so the row is still consulted, but through the cached runs above.
+	auto JumpVertical = [&IsFree, &JumpHorizontal, Width, GoalIndex](int32 X, int32 Y, int32 DY)
+	{
+		for (; IsFree(X, Y); Y += DY)
+		{
+			const int32 Index = Y * Width + X;
+			if (Index == GoalIndex
+				|| (IsFree(X - 1, Y) && !IsFree(X - 1, Y - DY))
+				|| (IsFree(X + 1, Y) && !IsFree(X + 1, Y - DY))
+				|| JumpHorizontal(X + 1, Y, 1) != INDEX_NONE
+				|| JumpHorizontal(X - 1, Y, -1) != INDEX_NONE)
+			{
+				return Index;
+			}
+		}
+		return int32(INDEX_NONE);
+	};
+
+	Visited[StartIndex] = Generation;
+	Parent[StartIndex] = StartIndex;
+	Cost[StartIndex] = 0;
+	Open.HeapPush(FOpenNode{ ManhattanDistance(Width, StartIndex, Goal), 0, StartIndex }, FOpenNodeLess());
+
+	while (Open.Num() > 0)
+	{
+		FOpenNode Node;
+		Open.HeapPop(Node, FOpenNodeLess(), EAllowShrinking::No);
+
+		if (Node.G > Cost[Node.Index])
+		{
+			continue;
+		}
+		++LastExpandedCount;
+
+		if (Node.Index == GoalIndex)
+		{
+			BuildPath(Width, StartIndex, GoalIndex, OutPath);
+			return true;
+		}
+
+		const int32 X = Node.Index % Width;
+		const int32 Y = Node.Index / Width;
+
+		// Keep going the way we came plus both sideways turns; the start expands all four ways
+		const int32 From = Parent[Node.Index];
+		const int32 DX = FMath::Sign(X - From % Width);
+		const int32 DY = FMath::Sign(Y - From / Width);
+		const bool bAll = From == Node.Index;
+		const int32 JumpPoints[4] = {
+			(bAll || DX != 0 || DY < 0) ? JumpVertical(X, Y - 1, -1)  : INDEX_NONE,
+			(bAll || DY != 0 || DX > 0) ? JumpHorizontal(X + 1, Y, 1) : INDEX_NONE,
+			(bAll || DX != 0 || DY > 0) ? JumpVertical(X, Y + 1, 1)   : INDEX_NONE,
+			(bAll || DY != 0 || DX < 0) ? JumpHorizontal(X - 1, Y, -1) : INDEX_NONE
+		};
+
+		for (const int32 Next : JumpPoints)
+		{
+			if (Next == INDEX_NONE)
+			{
+				continue;
+			}
+
+			// Jump points always lie on a straight line from the node
+			const int32 G = Node.G + FMath::Abs(Next % Width - X) + FMath::Abs(Next / Width - Y);
+			if (IsVisited(Next) && Cost[Next] <= G)
+			{
+				continue;
+			}
+
+			Visited[Next] = Generation;
+			Parent[Next] = Node.Index;
+			Cost[Next] = G;
+			Open.HeapPush(FOpenNode{ G + ManhattanDistance(Width, Next, Goal), G, Next }, FOpenNodeLess());
+		}
+	}
+
+	return false;
+}
+
+void FSnakePathfinder::BuildPath(int32 Width, int32 StartIndex, int32 GoalIndex, TArray<FIntPoint>& OutPath) const
+{
+	for (int32 At = GoalIndex; ; At = Parent[At])
+	{
+		const FIntPoint Cell(At % Width, At / Width);
+		OutPath.Add(Cell);
+		if (At == StartIndex)
+		{
+			break;
+		}
+
+		// Parent is a neighbour after A* and anywhere on the same row or column after JPS
+		const FIntPoint Towards(Parent[At] % Width, Parent[At] / Width);
+		const FIntPoint Step(FMath::Sign(Towards.X - Cell.X), FMath::Sign(Towards.Y - Cell.Y));
+		for (FIntPoint Between = Cell + Step; Between != Towards; Between += Step)
+		{
+			OutPath.Add(Between);
+		}
+	}
+	Algo::Reverse(OutPath);
+}
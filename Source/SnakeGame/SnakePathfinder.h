@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SnakeSimulation.h"
+
+/** Search strategy of FSnakePathfinder. Both return shortest paths. */
+enum class ESnakePathAlgorithm : uint8
+{
+	// Plain A*, expands every cell on the frontier
+	AStar,
+	// Jump Point Search for 4-connected grids: runs along straight lines and only queues cells
+	// where a turn may be needed, which skips most of an open arena
+	JumpPoint
+};
+
+/**
+ * A* over integer cell indices of a FSnakeSimulation grid.
+ *
+ * Parent, cost and visited arrays are flat, sized to the level and reused between searches;
+ * "visited" is a generation stamp so nothing has to be cleared before the next query.
+ * Keep one instance per searcher (it is not thread safe); worker threads should search a
+ * FSnakeGridSnapshot rather than the live simulation.
+ */
+class SNAKEGAME_API FSnakePathfinder
+{
+public:
+	/**
+	 * Shortest path from Start to Goal, both included in OutPath. Walls, void and every snake
+	 * body except the Start cell block the way.
+	 */
+	bool FindPath(const FSnakeSimulation& Sim, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath,
+		ESnakePathAlgorithm Algorithm = ESnakePathAlgorithm::AStar);
+
+	/** Same search against an immutable snapshot, for use on worker threads. */
+	bool FindPath(const FSnakeGridSnapshot& Snapshot, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath,
+		ESnakePathAlgorithm Algorithm = ESnakePathAlgorithm::AStar);
+
+	/** Number of cells (jump points for JumpPoint) expanded by the last search, for profiling. */
+	int32 GetLastExpandedCount() const { return LastExpandedCount; }
+
+protected:
+	struct FOpenNode
+	{
+		int32 F;
+		int32 G;
+		int32 Index;
+	};
+
+	/** Sizes the buffers for NumCells and starts a new generation. */
+	void BeginSearch(int32 NumCells);
+
+	bool IsVisited(int32 Index) const { return Visited[Index] == Generation; }
+
+	/** A* from Start to Goal over cells for which IsOpen(Index) is true. Call BeginSearch first. */
+	template <typename IsOpenFn>
+	bool Search(int32 Width, int32 Height, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath, IsOpenFn IsOpen);
+
+	/** Jump Point Search over the same buffers; Parent links jump points, not neighbouring cells. */
+	template <typename IsOpenFn>
+	bool SearchJumpPoint(int32 Width, int32 Height, const FIntPoint& Start, const FIntPoint& Goal, TArray<FIntPoint>& OutPath, IsOpenFn IsOpen);
+
+	/** Walks Parent back from GoalIndex; straight runs between jump points are filled in cell by cell. */
+	void BuildPath(int32 Width, int32 StartIndex, int32 GoalIndex, TArray<FIntPoint>& OutPath) const;
+
+	TArray<int32> Parent;
+	TArray<int32> Cost;
+	TArray<uint32> Visited;
+	TArray<uint32> BodyStamp;
+
+	// Jump point search only: where a horizontal run from a cell stops, two slots per cell
+	// (leftwards, rightwards), valid when the stamp matches Generation
+	TArray<int32> RunStop;
+	TArray<uint32> RunStamp;
+	uint32 Generation = 0;
+
+	TArray<FOpenNode> Open;
+	int32 LastExpandedCount = 0;
+};
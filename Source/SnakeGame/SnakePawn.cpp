@@ -1,10 +1,11 @@
 #include "SnakePawn.h"
-#include "SnakeTailSegment.h"
-#include "SnakeFood.h"
 #include "SnakeGameMode.h"
 #include "Components/StaticMeshComponent.h"
 #include "Materials/MaterialInterface.h"
+#include "Materials/MaterialInstanceDynamic.h"
 #include "SnakeWorld.h"
+#include "SnakeActorRegistry.h"
+#include "SnakeEffectsSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/WidgetComponent.h"
 #include "Sound/SoundBase.h"
@@ -13,10 +14,12 @@
 #include "EnhancedInputSubsystems.h"
 #include "Definitions.h"
 #include "SnakeAIController.h"
+#include "UObject/ConstructorHelpers.h"
 
 ASnakePawn::ASnakePawn()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Moved by USnakeTickManagerSubsystem together with every other snake
+	PrimaryActorTick.bCanEverTick = false;
 
 	SceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("SceneComponent"));
 	RootComponent = SceneComponent;
@@ -26,19 +29,25 @@ ASnakePawn::ASnakePawn()
 	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComponent"));
 	CollisionComponent->SetupAttachment(RootComponent);
 		
-	// Hard override collision
-	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	CollisionComponent->SetCollisionObjectType(ECollisionChannel::ECC_Pawn);
-	CollisionComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-	CollisionComponent->SetGenerateOverlapEvents(true);
-
-	// Create & configure the proximity sphere for "huh" sound
-	ProximitySphere = CreateDefaultSubobject<USphereComponent>(TEXT("ProximitySphere"));
-	ProximitySphere->SetupAttachment(RootComponent);
-	ProximitySphere->InitSphereRadius(300.f);
-	ProximitySphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	ProximitySphere->SetCollisionResponseToAllChannels(ECR_Overlap);
-	ProximitySphere->OnComponentBeginOverlap.AddDynamic(this, &ASnakePawn::OnProximityOverlapBegin);
+	// Wall, tail and food hits come from the world's occupancy grid, not from overlaps
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CollisionComponent->SetGenerateOverlapEvents(false);
+
+	// One instanced mesh for the whole tail. Instances are placed in world space,
+	// so keep the component itself at the origin instead of following the head.
+	TailInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("TailInstances"));
+	TailInstances->SetupAttachment(RootComponent);
+	TailInstances->SetUsingAbsoluteLocation(true);
+	TailInstances->SetUsingAbsoluteRotation(true);
+	TailInstances->SetUsingAbsoluteScale(true);
+	TailInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	TailInstances->SetGenerateOverlapEvents(false);
+	
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube"));
+	if (CubeMesh.Succeeded())
+	{
+		TailInstances->SetStaticMesh(CubeMesh.Object);
+	}
 
 	// Create question-mark widget
 	QuestionMarkWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("QuestionMarkWidget"));
@@ -54,140 +63,251 @@ void ASnakePawn::BeginPlay()
 	
 	if (CollisionComponent)
 	{
-		CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-		CollisionComponent->SetCollisionObjectType(ECollisionChannel::ECC_Pawn);
-		CollisionComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-		CollisionComponent->SetGenerateOverlapEvents(true);
+		CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		CollisionComponent->SetGenerateOverlapEvents(false);
 	}
 	
 	FVector SnappedLocation = SnapToGrid(GetActorLocation());
 	SetActorLocation(SnappedLocation);
 	LastTilePosition = SnappedLocation;
+	LogicLocation = SnappedLocation;
+	PreviousLogicLocation = SnappedLocation;
+	HeadHistory.Reset(SnappedLocation);
+	StartTransform = GetActorTransform();
+	StartDirection = Direction;
 	
-	if (CollisionComponent)
+	if (TailInstances)
+	{
+		UMaterialInterface* Material = TailMaterial;
+		if (!Material)
+		{
+			// TailInstances is a static mesh component too, so skip it when looking for the head
+			TArray<UStaticMeshComponent*> MeshComponents;
+			GetComponents<UStaticMeshComponent>(MeshComponents);
+			for (UStaticMeshComponent* HeadMesh : MeshComponents)
+			{
+				if (HeadMesh != TailInstances)
+				{
+					Material = HeadMesh->GetMaterial(0);
+					break;
+				}
+			}
+		}
+		if (Material)
+		{
+			TailInstances->SetMaterial(0, Material);
+		}
+		if (bOverrideTailColor)
+		{
+			SetTailColor(TailColor);
+		}
+	}
+	
+	USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this);
+	SnakeWorld = Registry ? Registry->GetSnakeWorld() : nullptr;
+	if (SnakeWorld)
+	{
+		SnakeId = SnakeWorld->RegisterSnake(LastTilePosition);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: no SnakeWorld found, snake will not collide."), *GetName());
+	}
+	if (Registry)
 	{
-		CollisionComponent->OnComponentBeginOverlap.AddDynamic(this, &ASnakePawn::OnOverlapBegin);
+		Registry->RegisterSnake(this);
 	}
 }
 
+void ASnakePawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this))
+	{
+		Registry->UnregisterSnake(this);
+	}
+	if (IsValid(SnakeWorld) && SnakeId != INDEX_NONE)
+	{
+		SnakeWorld->UnregisterSnake(SnakeId);
+	}
+	SnakeId = INDEX_NONE;
+	
+	Super::EndPlay(EndPlayReason);
+}
+
 FVector ASnakePawn::SnapToGrid(const FVector& InLocation)
 {
 	return ::SnapToGrid(InLocation);
 }
 
-void ASnakePawn::Tick(float DeltaTime)
+bool ASnakePawn::IsAliveInSimulation() const
 {
-	Super::Tick(DeltaTime);
-	
-	UpdateFalling(DeltaTime);
-	UpdateMovement(DeltaTime);
+	// Snakes without a world never collide, so they never die either
+	const FSnakeState* State = IsValid(SnakeWorld) ? SnakeWorld->GetSimulation().FindSnake(SnakeId) : nullptr;
+	return !State || State->bAlive;
+}
 
-	// Record the head's current 
-	const float RecordDistance = 10.0f;
-	FVector CurrentHeadPos = GetActorLocation();
-	if (HeadPositionHistory.Num() == 0 ||
-	    FVector::Dist(HeadPositionHistory.Last(), CurrentHeadPos) >= RecordDistance)
+bool ASnakePawn::StepMovement(float StepSeconds, int32 TileUnits, FIntPoint& OutCell)
+{
+	PreviousLogicLocation = LogicLocation;
+
+	// A dead snake stays where it died until ResetToStart brings it back
+	if (!IsAliveInSimulation())
 	{
-		HeadPositionHistory.Add(CurrentHeadPos);
+		return false;
 	}
-	
-	int32 MaxHistoryLength = (TailSegments.Num() + 1) * TailHistorySpacing + 10;
-	if (HeadPositionHistory.Num() > MaxHistoryLength)
+	UpdateFalling(StepSeconds);
+
+	// At most one tile per step, so no tile is ever skipped
+	TileProgress += FMath::Min(FMath::RoundToInt32(Speed), TileUnits);
+	if (TileProgress < TileUnits)
 	{
-		HeadPositionHistory.RemoveAt(0, HeadPositionHistory.Num() - MaxHistoryLength);
+		return false;
 	}
+	TileProgress -= TileUnits;
 
-	// Update tail to follow the head history
-	const float SmoothSpeed = 10.0f;
-	for (int32 i = 0; i < TailSegments.Num(); i++)
-	{
-		int32 HistoryIndex = HeadPositionHistory.Num() - 1 - (i + 1) * TailHistorySpacing;
-		HistoryIndex = FMath::Clamp(HistoryIndex, 0, HeadPositionHistory.Num() - 1);
+	// The rest of the step is taken in whatever direction the new tile turns us to
+	LastTilePosition = SnapToGrid(LastTilePosition + GetDirectionVector() * TileSize);
+	LastTilePosition.Z = LogicLocation.Z;
 
-		FVector TargetPos = HeadPositionHistory[HistoryIndex];
-		FVector CurrentPos = TailSegments[i]->GetActorLocation();
-		FVector NewPos = FMath::VInterpTo(CurrentPos, TargetPos, DeltaTime, SmoothSpeed);
-		TailSegments[i]->SetActorLocation(NewPos);
+	if (SnakeWorld && SnakeId != INDEX_NONE)
+	{
+		OutCell = SnakeWorld->WorldToCell(LastTilePosition);
+		return true;
 	}
+	UpdateDirection();
+	return false;
 }
 
-void ASnakePawn::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-								UPrimitiveComponent* OtherComp, int32 OtherBodyIndex,
-								bool bFromSweep, const FHitResult& SweepResult)
+void ASnakePawn::FinishStep(int32 TileUnits)
 {
-	if (!OtherActor)
+	if (!IsAliveInSimulation())
 	{
 		return;
 	}
 
-	// Collision with food
-	if (OtherActor->IsA(ASnakeFood::StaticClass()))
+	const FVector Along = GetDirectionVector() * (TileSize * TileProgress / TileUnits);
+	LogicLocation = FVector(LastTilePosition.X + Along.X, LastTilePosition.Y + Along.Y, LogicLocation.Z);
+}
+
+void ASnakePawn::RenderStep(float Alpha)
+{
+	SetActorLocation(FMath::Lerp(PreviousLogicLocation, LogicLocation, Alpha));
+
+	// Tail segments sit at fixed distances along the head's path, independent of frame rate
+	HeadHistory.AddPoint(GetActorLocation());
+	for (int32 i = 0; i < TailTransforms.Num(); i++)
 	{
-		GrowTail();
+		TailTransforms[i].SetLocation(HeadHistory.Sample((i + 1) * TailSegmentSpacing));
+	}
+	FlushTailInstances();
+}
 
-		if (EatParticle)
-		{
-			FVector SpawnLoc = OtherActor->GetActorLocation();
-			UGameplayStatics::SpawnEmitterAtLocation(
-				GetWorld(), EatParticle, SpawnLoc
-			);
-		}
+void ASnakePawn::FlushTailInstances()
+{
+	if (TailInstances && TailTransforms.Num() > 0)
+	{
+		TailInstances->BatchUpdateInstancesTransforms(0, TailTransforms, true, true, true);
+	}
+}
 
-		if (EatSound)
-		{
-			FVector SpawnLoc = OtherActor->GetActorLocation();
-			UGameplayStatics::PlaySoundAtLocation(GetWorld(), EatSound, SpawnLoc);
-		}
-		
-		OtherActor->Destroy();
+void ASnakePawn::EnterTile(const FSnakeMoveEvent& Event)
+{
+	HandleMoveEvent(Event);
+
+	// Food nearby is noticed from the grid, so the pawn needs no overlap volume for it
+	if (Event.Result == ESnakeMoveResult::Moved || Event.Result == ESnakeMoveResult::AteFood)
+	{
+		UpdateFoodProximity(Event.Cell);
+	}
+	UpdateDirection();
+}
 
-		// Notify GameMode
-		ASnakeGameMode* GM = Cast<ASnakeGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
-		if (GM)
+void ASnakePawn::HandleMoveEvent(const FSnakeMoveEvent& Event)
+{
+	switch (Event.Result)
+	{
+	case ESnakeMoveResult::AteFood:
 		{
-			int32 ControllerId = 0;
-			AController* Con = GetController();
+			GrowTail();
 
-			if (APlayerController* PC = Cast<APlayerController>(Con))
+			// Played from pooled components at the end of the frame
+			const FVector SpawnLoc = SnakeWorld->CellToWorld(Event.Cell);
+			if (USnakeEffectsSubsystem* Effects = GetWorld()->GetSubsystem<USnakeEffectsSubsystem>())
 			{
-				ControllerId = PC->GetLocalPlayer()->GetControllerId();
+				Effects->QueueEmitter(EatParticle, SpawnLoc);
+				Effects->QueueSound(EatSound, SpawnLoc);
 			}
-			else if (Cast<ASnakeAIController>(Con))
+			
+			SnakeWorld->ConsumeFood(Event.Cell);
+
+			// Notify GameMode
+			ASnakeGameMode* GM = Cast<ASnakeGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+			if (GM)
 			{
-				// AI always counts as player 2
-				ControllerId = 1;
+				int32 ControllerId = 0;
+				AController* Con = GetController();
+
+				if (APlayerController* PC = Cast<APlayerController>(Con))
+				{
+					ControllerId = PC->GetLocalPlayer()->GetControllerId();
+				}
+				else if (Cast<ASnakeAIController>(Con))
+				{
+					// AI always counts as player 2
+					ControllerId = 1;
+				}
+
+				GM->NotifyAppleEaten(ControllerId);
 			}
-
-			GM->NotifyAppleEaten(ControllerId);
 		}
-	}
+		break;
 
-	// Collision with Tail
-	if (OtherActor->IsA(ASnakeTailSegment::StaticClass()))
-	{
-		ASnakeTailSegment* TailSeg = Cast<ASnakeTailSegment>(OtherActor);
-		if (TailSeg && TailSeg->bCanCollide)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Collision with tail detected! Game Over!"));
-			GameOver();
-			return;
-		}
-		else
-		{
-			return;
-		}
-	}
+	case ESnakeMoveResult::HitSnake:
+		UE_LOG(LogTemp, Warning, TEXT("Collision with tail detected! Game Over!"));
+		GameOver();
+		break;
 
-	// Collision with Walls
-	if (OtherActor->ActorHasTag("Wall") || (OtherComp && OtherComp->ComponentHasTag("Wall")))
-	{
+	case ESnakeMoveResult::HitWall:
 		UE_LOG(LogTemp, Warning, TEXT("Collision with wall detected! Game Over!"));
 		GameOver();
-		return;
+		break;
+
+	default:
+		break;
 	}
 }
 
+void ASnakePawn::ResetToStart()
+{
+	SetActorTransform(StartTransform, false, nullptr, ETeleportType::ResetPhysics);
+	LastTilePosition = StartTransform.GetLocation();
+	LogicLocation = LastTilePosition;
+	PreviousLogicLocation = LastTilePosition;
+	HeadHistory.Reset(LastTilePosition);
+
+	Direction = StartDirection;
+	DirectionQueue.Reset();
+	TileProgress = 0;
+	VelocityZ = 0.0f;
+	bInAir = false;
+	NearbyFood.Reset();
+
+	// Keep the instance buffers allocated, the next run grows into them again
+	TailTransforms.Reset();
+	if (TailInstances)
+	{
+		TailInstances->ClearInstances();
+	}
 
+	if (IsValid(SnakeWorld) && SnakeId != INDEX_NONE)
+	{
+		SnakeWorld->ResetSnake(SnakeId, LastTilePosition);
+	}
+	if (ASnakeAIController* AIController = Cast<ASnakeAIController>(GetController()))
+	{
+		AIController->ResetPlan();
+	}
+}
 
 void ASnakePawn::GameOver()
 {
@@ -196,7 +316,7 @@ void ASnakePawn::GameOver()
 	ASnakeGameMode* GameMode = Cast<ASnakeGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
 	if (GameMode)
 	{
-		GameMode->SetGameState(EGameState::Outro);
+		GameMode->NotifySnakeDied();
 	}
 
 	/* // Restart the current level.
@@ -210,33 +330,45 @@ void ASnakePawn::GameOver()
 	*/
 }
 
-void ASnakePawn::OnProximityOverlapBegin(UPrimitiveComponent* OverlappedComp,
-										 AActor* OtherActor,
-										 UPrimitiveComponent* OtherComp,
-										 int32 OtherBodyIndex,
-										 bool bFromSweep,
-										 const FHitResult& SweepResult)
+void ASnakePawn::UpdateFoodProximity(const FIntPoint& Head)
 {
-	if (OtherActor && OtherActor->IsA(ASnakeFood::StaticClass()))
+	NearbyFoodScratch.Reset();
+	const int32 RadiusCells = FMath::FloorToInt32(ProximityRadius / TileSize);
+	SnakeWorld->GetSimulation().FindFoodInRadius(Head, RadiusCells, NearbyFoodScratch);
+
+	// Same "begin overlap" behaviour the sphere had: react when an apple comes into range
+	bool bNewFood = false;
+	for (const FIntPoint& Cell : NearbyFoodScratch)
 	{
-		// play notice sound "huh"
-		if (NoticeSound)
-		{
-			UGameplayStatics::PlaySoundAtLocation(this, NoticeSound, GetActorLocation());
-		}
+		bNewFood |= !NearbyFood.Contains(Cell);
+	}
+	Swap(NearbyFood, NearbyFoodScratch);
 
-		// show the question-mark widget briefly
-		if (QuestionMarkWidget)
-		{
-			QuestionMarkWidget->SetVisibility(true);
-			GetWorld()->GetTimerManager().SetTimer(
-				QuestionMarkTimerHandle,
-				this,
-				&ASnakePawn::HideQuestionMark,
-				0.5f,    // half a second
-				false
-			);
-		}
+	if (bNewFood)
+	{
+		NoticeFood();
+	}
+}
+
+void ASnakePawn::NoticeFood()
+{
+	// play notice sound "huh"
+	if (USnakeEffectsSubsystem* Effects = GetWorld()->GetSubsystem<USnakeEffectsSubsystem>())
+	{
+		Effects->QueueSound(NoticeSound, GetActorLocation());
+	}
+
+	// show the question-mark widget briefly
+	if (QuestionMarkWidget)
+	{
+		QuestionMarkWidget->SetVisibility(true);
+		GetWorld()->GetTimerManager().SetTimer(
+			QuestionMarkTimerHandle,
+			this,
+			&ASnakePawn::HideQuestionMark,
+			0.5f,    // half a second
+			false
+		);
 	}
 }
 
@@ -272,60 +404,10 @@ void ASnakePawn::HandlePauseToggle()
 	}
 }
 
-void ASnakePawn::MoveSnake(float Distance)
-{
-	FVector Position = GetActorLocation();
-	
-	switch (Direction)
-	{
-	case ESnakeDirection::Up:
-		Position.X += Distance;
-		break;
-	case ESnakeDirection::Right:
-		Position.Y += Distance;
-		break;
-	case ESnakeDirection::Down:
-		Position.X -= Distance;
-		break;
-	case ESnakeDirection::Left:
-		Position.Y -= Distance;
-		break;
-	}
-
-	SetActorLocation(Position);
-	MovedTileDistance += Distance;
-}
-
-void ASnakePawn::UpdateMovement(float DeltaTime)
-{
-	float DistanceToTravel = Speed * DeltaTime;
-	FVector CurrentPosition = GetActorLocation();
-
-	while (DistanceToTravel > 0.f)
-	{
-		float Step = FMath::Min(DistanceToTravel, TileSize - MovedTileDistance);
-		CurrentPosition += GetDirectionVector() * Step;
-		MovedTileDistance += Step;
-		DistanceToTravel -= Step;
-
-		if (MovedTileDistance >= TileSize - KINDA_SMALL_NUMBER)
-		{
-			// Snap exactly to grid, reset counters, update history
-			FVector Snapped = SnapToGrid(CurrentPosition);
-			LastTilePosition = Snapped;
-			CurrentPosition = Snapped;
-			MovedTileDistance = 0.f;
-
-			UpdateTailTargets(LastTilePosition);
-			UpdateDirection();
-		}
-	}
-	SetActorLocation(CurrentPosition);
-}
-
 void ASnakePawn::UpdateFalling(float DeltaTime)
 {
-	FVector Position = GetActorLocation();
+	// Runs once per logic step, so the per-step velocity is frame rate independent
+	FVector& Position = LogicLocation;
 	VelocityZ -= 10.0f * DeltaTime;
 	Position.Z += VelocityZ;
 
@@ -345,8 +427,6 @@ void ASnakePawn::UpdateFalling(float DeltaTime)
 	{
 		bInAir = true;
 	}
-
-	SetActorLocation(Position);
 }
 
 void ASnakePawn::Jump()
@@ -408,89 +488,41 @@ void ASnakePawn::SetNextDirection(ESnakeDirection InDirection)
 	DirectionQueue.Add(InDirection);
 }
 
-void ASnakePawn::GrowTail()
+void ASnakePawn::SetTailColor(const FLinearColor& InColor)
 {
-	if (!GetWorld())
+	TailColor = InColor;
+	bOverrideTailColor = true;
+	if (!TailInstances)
 	{
 		return;
 	}
 
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner = this;  
-	UClass* SpawnClass = TailSegmentClass.Get() ? TailSegmentClass.Get()
-												: ASnakeTailSegment::StaticClass();
-
-	ASnakeTailSegment* NewSegment = GetWorld()->SpawnActor<ASnakeTailSegment>(
-		SpawnClass,
-		LastTilePosition,
-		FRotator::ZeroRotator,
-		SpawnParams
-	);
-
-	
-	if (NewSegment)
+	// One colour per snake, so one dynamic instance shared by every segment is enough. "Color"
+	// is the vector parameter of M_Snake, which the head instances and so the tail derive from.
+	static const FName TailColorParameter(TEXT("Color"));
+	UMaterialInstanceDynamic* Dynamic = Cast<UMaterialInstanceDynamic>(TailInstances->GetMaterial(0));
+	if (!Dynamic)
 	{
-		if (UStaticMeshComponent* HeadMesh = FindComponentByClass<UStaticMeshComponent>())
-		{
-			if (UMaterialInterface* HeadMat = HeadMesh->GetMaterial(0))
-			{
-				NewSegment->MeshComponent->SetMaterial(0, HeadMat);
-			}
-		}
-		
-		NewSegment->MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		NewSegment->bCanCollide = false;
-		
-		FTimerHandle TimerHandle;
-		FTimerDelegate TimerDel;
-		TimerDel.BindLambda([NewSegment]()
-		{
-			if (NewSegment)
-			{
-				NewSegment->MeshComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-				NewSegment->bCanCollide = true;
-			}
-		});
-		GetWorld()->GetTimerManager().SetTimer(TimerHandle, TimerDel, 0.3f, false);
-		
-		TailSegments.Add(NewSegment);
-		TailTargetPositions.Add(LastTilePosition);
-
-		UE_LOG(LogTemp, Warning, TEXT("Tail grown. Total segments: %d"), TailSegments.Num());
+		Dynamic = TailInstances->CreateAndSetMaterialInstanceDynamic(0);
 	}
-}
-
-
-
-void ASnakePawn::UpdateTailTargets(const FVector& PreviousHeadPosition)
-{
-	if (TailSegments.Num() > 0)
+	if (Dynamic)
 	{
-		TailTargetPositions[0] = PreviousHeadPosition;
-		for (int32 i = 1; i < TailSegments.Num(); i++)
-		{
-			TailTargetPositions[i] = TailTargetPositions[i - 1];
-		}
+		Dynamic->SetVectorParameterValue(TailColorParameter, InColor);
 	}
 }
 
-void ASnakePawn::UpdateTailPositions(const FVector& PreviousTilePosition)
+void ASnakePawn::GrowTail()
 {
-	if (TailSegments.Num() > 0)
+	if (!TailInstances)
 	{
-		TArray<FVector> OldPositions;
-		OldPositions.SetNum(TailSegments.Num());
-
-		for (int32 i = 0; i < TailSegments.Num(); i++)
-		{
-			OldPositions[i] = TailSegments[i]->GetActorLocation();
-		}
+		return;
+	}
 
-		TailSegments[0]->SetActorLocation(PreviousTilePosition);
+	const FTransform SegmentTransform(FRotator::ZeroRotator, LastTilePosition, FVector(0.5f));
+	TailInstances->AddInstance(SegmentTransform, true);
+	TailTransforms.Add(SegmentTransform);
+	HeadHistory.EnsureLength((TailTransforms.Num() + 1) * TailSegmentSpacing);
 
-		for (int32 i = 1; i < TailSegments.Num(); i++)
-		{
-			TailSegments[i]->SetActorLocation(OldPositions[i - 1]);
-		}
-	}
+	UE_LOG(LogTemp, Verbose, TEXT("Tail grown. Total segments: %d"), TailTransforms.Num());
 }
+
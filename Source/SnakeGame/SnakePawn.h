@@ -5,10 +5,13 @@
 #include "GameFramework/Pawn.h"
 #include "Components/SphereComponent.h"
 #include "Components/WidgetComponent.h"    
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Sound/SoundBase.h"
+#include "SnakeHeadHistory.h"
 #include "SnakePawn.generated.h"
 
-class ASnakeTailSegment;
+class ASnakeWorld;
+struct FSnakeMoveEvent;
 
 UCLASS()
 class SNAKEGAME_API ASnakePawn : public APawn
@@ -26,8 +29,8 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effects")
 	USoundBase* EatSound;
 	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Detection", meta=(AllowPrivateAccess="true"))
-	USphereComponent* ProximitySphere;  
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Detection", meta=(ClampMin="0", ToolTip="Food coming this close to the head (cm) makes the snake notice it."))
+	float ProximityRadius = 300.0f;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Effects")
 	UWidgetComponent* QuestionMarkWidget;  
@@ -41,24 +44,51 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	ESnakeDirection Direction = ESnakeDirection::None;
 	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snake")
-	TArray<ASnakeTailSegment*> TailSegments;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snake|Tail", meta = (ToolTip = "Draws every tail segment of this snake as one instance."))
+	UInstancedStaticMeshComponent* TailInstances;
 	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snake")
-	FVector LastTilePosition;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Snake|Tail", meta = (InlineEditConditionToggle))
+	bool bOverrideTailColor = false;
 	
-	UFUNCTION(BlueprintCallable, Category = "Snake")
-	void GrowTail();
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Snake|Tail", meta = (EditCondition = "bOverrideTailColor", ToolTip = "Set on the tail material's Color parameter; replaces the per-player tail blueprints."))
+	FLinearColor TailColor = FLinearColor::White;
 	
-	void UpdateTailTargets(const FVector& PreviousHeadPosition);
+	/** Recolours the whole tail through a dynamic instance of its material. */
+	UFUNCTION(BlueprintCallable, Category = "Snake|Tail")
+	void SetTailColor(const FLinearColor& InColor);
 	
-	UFUNCTION(BlueprintCallable, Category = "Snake")
-	void UpdateTailPositions(const FVector& PreviousTilePosition);
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Snake|Tail", meta = (ToolTip = "Tail material. Falls back to the head material when empty."))
+	UMaterialInterface* TailMaterial = nullptr;
+	
+	UFUNCTION(BlueprintPure, Category = "Snake|Tail")
+	int32 GetTailLength() const { return TailTransforms.Num(); }
 	
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snake")
-	TArray<FVector> TailTargetPositions;
+	FVector LastTilePosition;
 	
-	virtual void Tick(float DeltaTime) override;
+	UFUNCTION(BlueprintCallable, Category = "Snake")
+	void GrowTail();
+	
+	// ─── Driven by USnakeTickManagerSubsystem ────────────────────────
+	/**
+	 * One fixed logic step. Progress along the tile is an integer: a tile is TileUnits long and
+	 * the snake covers Speed units per step, so TileUnits = TileSize * steps per second gives
+	 * Speed in cm/s with no rounding. Returns true with the cell reached when the simulation
+	 * has to resolve it; EnterTile then gets the outcome.
+	 */
+	bool StepMovement(float StepSeconds, int32 TileUnits, FIntPoint& OutCell);
+
+	/** Reacts to the simulation's outcome for the tile StepMovement reached. */
+	void EnterTile(const FSnakeMoveEvent& Event);
+
+	/** Places the logic head once this step's turns are known. */
+	void FinishStep(int32 TileUnits);
+
+	/** False once the simulation has killed this snake; it then stops moving until ResetToStart. */
+	bool IsAliveInSimulation() const;
+
+	/** Once per frame: draws the head Alpha of the way from the previous to the current step, and the tail behind it. */
+	void RenderStep(float Alpha);
 
 	void HandlePauseToggle();
 	
@@ -70,16 +100,15 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (ToolTip = "Add a direction onto a queue where the first in line direction gets set and popped."))
 	void SetNextDirection(ESnakeDirection InDirection);
 	
-	UFUNCTION()
-	void OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	                    UPrimitiveComponent* OtherComp, int32 OtherBodyIndex,
-	                    bool bFromSweep, const FHitResult & SweepResult);
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Snake", meta = (ToolTip = "Id of this snake in the world simulation."))
+	int32 SnakeId = INDEX_NONE;
 	
 	UFUNCTION(BlueprintCallable, Category = "Game")
 	void GameOver();
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Snake")
-	TSubclassOf<ASnakeTailSegment> TailSegmentClass;
+	/** Soft restart: back to where the snake began play, without a tail and standing still. */
+	UFUNCTION(BlueprintCallable, Category = "Game")
+	void ResetToStart();
 
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (ToolTip = "Used for falling and jumping."))
@@ -97,42 +126,56 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TArray<ESnakeDirection> DirectionQueue;
 	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (ToolTip = "How long the snake has moved since reaching the last tile."))
-	float MovedTileDistance = 0.0f;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (ToolTip = "Fixed-point progress from the last tile towards the next, in the tick manager's tile units."))
+	int32 TileProgress = 0;
+	
+	// Head position after the last two logic steps; the actor is drawn between them
+	FVector PreviousLogicLocation = FVector::ZeroVector;
+	FVector LogicLocation = FVector::ZeroVector;
 	
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	UFUNCTION()
 	void UpdateDirection();
 
 	FVector GetDirectionVector() const;
 	
-	UFUNCTION()
-	void UpdateMovement(float DeltaTime);
-	
-	UFUNCTION()
-	void MoveSnake(float Distance);
-	
 	UFUNCTION()
 	void UpdateFalling(float DeltaTime);
 
 private:
-	TArray<FVector> HeadPositionHistory;
+	UPROPERTY()
+	ASnakeWorld* SnakeWorld = nullptr;
 	
-	UPROPERTY(EditAnywhere, Category = "Snake|Tail")
-	int32 TailHistorySpacing = 5;
+	void HandleMoveEvent(const FSnakeMoveEvent& Event);
+	
+	// World-space transforms of the tail instances, pushed to TailInstances in one batch per frame
+	TArray<FTransform> TailTransforms;
+	
+	void FlushTailInstances();
+	
+	FSnakeHeadHistory HeadHistory;
+	
+	// Distance along the head's path between two tail segments. One segment per body cell of the
+	// simulation, so the drawn tail covers exactly the cells that kill; not editable for that reason
+	static constexpr float TailSegmentSpacing = TileSize;
 	
 	static FVector SnapToGrid(const FVector& InLocation);
 
+	// Where BeginPlay found the snake, for ResetToStart
+	FTransform StartTransform;
+	ESnakeDirection StartDirection = ESnakeDirection::None;
+
 	FTimerHandle QuestionMarkTimerHandle;
 	
-	UFUNCTION()
-	void OnProximityOverlapBegin(UPrimitiveComponent* OverlappedComp,
-								 AActor* OtherActor,
-								 UPrimitiveComponent* OtherComp,
-								 int32 OtherBodyIndex,
-								 bool bFromSweep,
-								 const FHitResult& SweepResult);
+	// Food cells within ProximityRadius on the last tile; only food new to this list is noticed
+	TArray<FIntPoint> NearbyFood;
+	TArray<FIntPoint> NearbyFoodScratch;
+
+	/** Grid query against the simulation's food, run once per tile entered. */
+	void UpdateFoodProximity(const FIntPoint& Head);
+	void NoticeFood();
 	
 	void HideQuestionMark();
 };
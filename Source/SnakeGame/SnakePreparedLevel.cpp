@@ -0,0 +1,44 @@
+#include "SnakePreparedLevel.h"
+
+#include "Definitions.h"
+
+TSharedRef<FSnakePreparedLevel> FSnakePreparedLevel::Prepare(int32 LevelIndex)
+{
+	TSharedRef<FSnakePreparedLevel> Prepared = MakeShared<FSnakePreparedLevel>();
+	Prepared->LevelIndex = LevelIndex;
+	if (!FSnakeLevelData::Exists(LevelIndex) || !FSnakeLevelData::Load(LevelIndex, Prepared->Level))
+	{
+		return Prepared;
+	}
+	Prepared->bLoaded = true;
+
+	const FSnakeLevelData& Level = Prepared->Level;
+	auto TileTransform = [&Level](const FIntPoint& Cell)
+	{
+		return FTransform(FRotator::ZeroRotator, FVector((Level.Height - Cell.Y) * TileSize, Cell.X * TileSize, 0.0f));
+	};
+
+	Prepared->FloorTransforms.Reserve(Level.FloorCells.Num() + Level.DoorCells.Num());
+	Prepared->DoorTransforms.Reserve(Level.DoorCells.Num());
+	for (int32 Y = 0; Y < Level.Height; ++Y)
+	{
+		for (int32 X = 0; X < Level.Width; ++X)
+		{
+			if (Level.Cells[Y * Level.Width + X] == ESnakeCell::Wall)
+			{
+				Prepared->WallTransforms.Add(TileTransform(FIntPoint(X, Y)));
+			}
+		}
+	}
+	for (const FIntPoint& Cell : Level.FloorCells)
+	{
+		Prepared->FloorTransforms.Add(TileTransform(Cell));
+	}
+	for (const FIntPoint& Cell : Level.DoorCells)
+	{
+		const FTransform Transform = TileTransform(Cell);
+		Prepared->FloorTransforms.Add(Transform);
+		Prepared->DoorTransforms.Add(Transform);
+	}
+	return Prepared;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SnakeLevelData.h"
+
+/**
+ * Everything ASnakeWorld needs to show a level, computed without touching any UObject: the parsed
+ * grid plus the wall, floor and door transforms relative to the world actor. Prepare() is safe to
+ * run on a worker thread, so the next level can be ready before the current one is finished and
+ * switching is only a copy of these buffers into the instanced components.
+ */
+struct SNAKEGAME_API FSnakePreparedLevel
+{
+	int32 LevelIndex = INDEX_NONE;
+
+	// False when no file exists for LevelIndex or it failed to parse
+	bool bLoaded = false;
+
+	FSnakeLevelData Level;
+
+	TArray<FTransform> WallTransforms;
+
+	// Floor tiles followed by door tiles, the order the floor instances are added in
+	TArray<FTransform> FloorTransforms;
+
+	TArray<FTransform> DoorTransforms;
+
+	/** Loads LevelIndex and builds the transforms. Never touches UObjects. */
+	static TSharedRef<FSnakePreparedLevel> Prepare(int32 LevelIndex);
+};
@@ -0,0 +1,502 @@
+#include "SnakeSimulation.h"
+
+void FSnakeBody::Reset(const FIntPoint& Head)
+{
+	Cells.SetNum(8);
+	HeadIndex = 0;
+	Count = 1;
+	Cells[0] = Head;
+}
+
+void FSnakeBody::PushHead(const FIntPoint& Cell)
+{
+	if (Count == Cells.Num())
+	{
+		Grow();
+	}
+	HeadIndex = (HeadIndex - 1) & (Cells.Num() - 1);
+	Cells[HeadIndex] = Cell;
+	++Count;
+}
+
+FIntPoint FSnakeBody::PopTail()
+{
+	check(Count > 0);
+	const FIntPoint Tail = GetTail();
+	--Count;
+	return Tail;
+}
+
+void FSnakeBody::Grow()
+{
+	// Unroll into a buffer twice the size so the head starts at 0 again
+	TArray<FIntPoint> NewCells;
+	NewCells.SetNum(FMath::Max(8, Cells.Num() * 2));
+	for (int32 i = 0; i < Count; ++i)
+	{
+		NewCells[i] = (*this)[i];
+	}
+	Cells = MoveTemp(NewCells);
+	HeadIndex = 0;
+}
+
+FSnakeSimulation::FSnakeSimulation(int32 InSeed)
+	: Random(InSeed)
+{
+}
+
+void FSnakeSimulation::SetGrid(const FSnakeLevelData& Level)
+{
+	check(Level.IsValid());
+
+	Width = Level.Width;
+	Height = Level.Height;
+	Cells.SetNum(Level.Cells.Num());
+	for (int32 Index = 0; Index < Cells.Num(); ++Index)
+	{
+		Cells[Index] = FSnakeGridCell();
+		Cells[Index].Terrain = Level.Cells[Index];
+	}
+
+	FloorCells = Level.FloorCells;
+	Terrain = MakeShared<TArray<ESnakeCell>>(Level.Cells);
+	CachedSnapshot.Reset();
+
+	// Without interior tiles any floor tile will do
+	const TArray<FIntPoint>& SpawnCandidates = Level.SpawnCells.Num() > 0 ? Level.SpawnCells : Level.FloorCells;
+	FreeSpawnCells.Reset(Cells.Num());
+	for (const FIntPoint& Cell : SpawnCandidates)
+	{
+		const int32 Index = ToIndex(Cell);
+		Cells[Index].bFoodSpawn = true;
+		FreeSpawnCells.Add(Index);
+	}
+
+	FoodCells.Reset();
+	++FoodVersion;
+
+	// Snakes survive a level change, so put their bodies back into the new grid
+	for (const FSnakeState& Snake : Snakes)
+	{
+		// Walk tail to head so a cell the body covers twice keeps its newest stamp
+		for (int32 i = Snake.Body.Num() - 1; i >= 0; --i)
+		{
+			OccupyCell(Snake.Body[i], Snake.Id, Snake.TilesMoved - uint32(i));
+		}
+	}
+}
+
+void FSnakeSimulation::OccupyCell(const FIntPoint& Cell, int32 SnakeId, uint32 EnteredAt)
+{
+	if (IsInBounds(Cell))
+	{
+		const int32 Index = ToIndex(Cell);
+		FSnakeGridCell& GridCell = Cells[Index];
+		GridCell.Occupant = ESnakeOccupant::Body;
+		GridCell.OwnerId = SnakeId;
+		GridCell.EnteredAt = EnteredAt;
+		FreeSpawnCells.Remove(Index);
+		++BodyVersion;
+	}
+}
+
+void FSnakeSimulation::VacateCell(const FIntPoint& Cell, int32 SnakeId)
+{
+	if (IsInBounds(Cell))
+	{
+		const int32 Index = ToIndex(Cell);
+		FSnakeGridCell& GridCell = Cells[Index];
+		if (GridCell.Occupant == ESnakeOccupant::Body && GridCell.OwnerId == SnakeId)
+		{
+			GridCell.Occupant = ESnakeOccupant::None;
+			GridCell.OwnerId = INDEX_NONE;
+			ReleaseSpawnCell(Index);
+			++BodyVersion;
+		}
+	}
+}
+
+void FSnakeSimulation::ReleaseSpawnCell(int32 CellIndex)
+{
+	const FSnakeGridCell& GridCell = Cells[CellIndex];
+	if (GridCell.bFoodSpawn && GridCell.Occupant == ESnakeOccupant::None)
+	{
+		FreeSpawnCells.Add(CellIndex);
+	}
+}
+
+TSharedRef<const FSnakeGridSnapshot> FSnakeSimulation::GetSnapshot() const
+{
+	if (CachedSnapshot.IsValid() && CachedSnapshotVersion == BodyVersion)
+	{
+		return CachedSnapshot.ToSharedRef();
+	}
+
+	TSharedRef<FSnakeGridSnapshot> Snapshot = MakeShared<FSnakeGridSnapshot>();
+	Snapshot->Width = Width;
+	Snapshot->Height = Height;
+	Snapshot->Terrain = Terrain;
+	for (const FSnakeState& Snake : Snakes)
+	{
+		for (int32 i = 0; i < Snake.Body.Num(); ++i)
+		{
+			if (IsInBounds(Snake.Body[i]))
+			{
+				Snapshot->BodyCells.Add(ToIndex(Snake.Body[i]));
+			}
+		}
+	}
+
+	CachedSnapshot = Snapshot;
+	CachedSnapshotVersion = BodyVersion;
+	return Snapshot;
+}
+
+FVector FSnakeSimulation::CellToLocal(const FIntPoint& Cell) const
+{
+	// Row 0 of the file is the far end of the arena along +X
+	return FVector((Height - Cell.Y) * TileSize, Cell.X * TileSize, 0.0f);
+}
+
+FIntPoint FSnakeSimulation::LocalToCell(const FVector& Local) const
+{
+	return FIntPoint(
+		FMath::RoundToInt(Local.Y / TileSize),
+		Height - FMath::RoundToInt(Local.X / TileSize)
+	);
+}
+
+FIntPoint FSnakeSimulation::GetDirectionOffset(ESnakeDirection InDirection)
+{
+	// Up is +X in the world, which is one row towards the top of the file
+	switch (InDirection)
+	{
+	case ESnakeDirection::Up:    return FIntPoint(0, -1);
+	case ESnakeDirection::Right: return FIntPoint(1, 0);
+	case ESnakeDirection::Down:  return FIntPoint(0, 1);
+	case ESnakeDirection::Left:  return FIntPoint(-1, 0);
+	default:                     return FIntPoint::ZeroValue;
+	}
+}
+
+ESnakeDirection FSnakeSimulation::GetDirectionBetween(const FIntPoint& From, const FIntPoint& To)
+{
+	const FIntPoint Delta = To - From;
+	if (Delta == FIntPoint(0, -1)) return ESnakeDirection::Up;
+	if (Delta == FIntPoint(1, 0))  return ESnakeDirection::Right;
+	if (Delta == FIntPoint(0, 1))  return ESnakeDirection::Down;
+	if (Delta == FIntPoint(-1, 0)) return ESnakeDirection::Left;
+	return ESnakeDirection::None;
+}
+
+int32 FSnakeSimulation::AddSnake(const FIntPoint& Start, ESnakeDirection InDirection)
+{
+	FSnakeState& Snake = Snakes.AddDefaulted_GetRef();
+	Snake.Id = NextSnakeId++;
+	Snake.Body.Reset(Start);
+	Snake.Direction = InDirection;
+	OccupyCell(Start, Snake.Id, Snake.TilesMoved);
+	return Snake.Id;
+}
+
+void FSnakeSimulation::RemoveSnake(int32 SnakeId)
+{
+	if (const FSnakeState* Snake = FindSnake(SnakeId))
+	{
+		for (int32 i = 0; i < Snake->Body.Num(); ++i)
+		{
+			VacateCell(Snake->Body[i], SnakeId);
+		}
+	}
+
+	// Keep the remaining snakes in insertion order, Step() relies on it
+	Snakes.RemoveAll([SnakeId](const FSnakeState& Snake) { return Snake.Id == SnakeId; });
+}
+
+void FSnakeSimulation::ResetSnake(int32 SnakeId, const FIntPoint& Start)
+{
+	FSnakeState* Snake = FindSnakeMutable(SnakeId);
+	if (!Snake)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Snake->Body.Num(); ++i)
+	{
+		VacateCell(Snake->Body[i], SnakeId);
+	}
+
+	Snake->Body.Reset(Start);
+	Snake->Direction = ESnakeDirection::None;
+	Snake->DirectionQueue.Reset();
+	Snake->PendingGrowth = 0;
+	Snake->bAlive = true;
+	Snake->TilesMoved = 0;
+	Snake->LastGrowthAt = 0;
+	OccupyCell(Start, SnakeId, Snake->TilesMoved);
+}
+
+const FSnakeState* FSnakeSimulation::FindSnake(int32 SnakeId) const
+{
+	return Snakes.FindByPredicate([SnakeId](const FSnakeState& Snake) { return Snake.Id == SnakeId; });
+}
+
+FSnakeState* FSnakeSimulation::FindSnakeMutable(int32 SnakeId)
+{
+	return Snakes.FindByPredicate([SnakeId](const FSnakeState& Snake) { return Snake.Id == SnakeId; });
+}
+
+void FSnakeSimulation::QueueDirection(int32 SnakeId, ESnakeDirection InDirection)
+{
+	if (FSnakeState* Snake = FindSnakeMutable(SnakeId))
+	{
+		Snake->DirectionQueue.Add(InDirection);
+	}
+}
+
+FSnakeMoveEvent FSnakeSimulation::MoveSnakeHead(int32 SnakeId, const FIntPoint& Cell)
+{
+	if (FSnakeState* Snake = FindSnakeMutable(SnakeId))
+	{
+		return MoveSnake(*Snake, Cell);
+	}
+	return FSnakeMoveEvent();
+}
+
+void FSnakeSimulation::ResolveMoves(TArray<FSnakeMoveRequest>& Requests, TArray<FSnakeMoveEvent>& OutEvents)
+{
+	Requests.Sort([](const FSnakeMoveRequest& A, const FSnakeMoveRequest& B) { return A.SnakeId < B.SnakeId; });
+
+	auto IsMoving = [this](const FSnakeMoveRequest& Request)
+	{
+		const FSnakeState* Snake = FindSnake(Request.SnakeId);
+		return Snake && Snake->bAlive && Snake->Body.GetHead() != Request.Cell;
+	};
+
+	// Two heads entering one cell: neither got there first, so neither wins. Found before anyone
+	// moves so the outcome does not depend on which of them is resolved first
+	HeadOnIds.Reset();
+	HeadOnIds.Init(INDEX_NONE, Requests.Num());
+	for (int32 i = 0; i < Requests.Num(); ++i)
+	{
+		for (int32 j = i + 1; j < Requests.Num(); ++j)
+		{
+			if (Requests[i].Cell == Requests[j].Cell && IsMoving(Requests[i]) && IsMoving(Requests[j]))
+			{
+				HeadOnIds[i] = Requests[j].SnakeId;
+				HeadOnIds[j] = Requests[i].SnakeId;
+			}
+		}
+	}
+
+	for (int32 i = 0; i < Requests.Num(); ++i)
+	{
+		FSnakeState* Snake = FindSnakeMutable(Requests[i].SnakeId);
+		if (!Snake)
+		{
+			continue;
+		}
+
+		if (HeadOnIds[i] != INDEX_NONE)
+		{
+			Snake->bAlive = false;
+
+			FSnakeMoveEvent& Event = OutEvents.AddDefaulted_GetRef();
+			Event.SnakeId = Snake->Id;
+			Event.Result = ESnakeMoveResult::HitSnake;
+			Event.Cell = Requests[i].Cell;
+			Event.OtherSnakeId = HeadOnIds[i];
+			continue;
+		}
+
+		OutEvents.Add(MoveSnake(*Snake, Requests[i].Cell));
+	}
+}
+
+void FSnakeSimulation::Step(TArray<FSnakeMoveEvent>& OutEvents)
+{
+	StepRequests.Reset();
+	for (FSnakeState& Snake : Snakes)
+	{
+		if (!Snake.bAlive)
+		{
+			continue;
+		}
+
+		if (Snake.DirectionQueue.Num() > 0)
+		{
+			Snake.Direction = Snake.DirectionQueue[0];
+			Snake.DirectionQueue.RemoveAt(0);
+		}
+
+		if (Snake.Direction == ESnakeDirection::None)
+		{
+			continue;
+		}
+
+		StepRequests.Add({ Snake.Id, Snake.Body.GetHead() + GetDirectionOffset(Snake.Direction) });
+	}
+	ResolveMoves(StepRequests, OutEvents);
+}
+
+FSnakeMoveEvent FSnakeSimulation::MoveSnake(FSnakeState& Snake, const FIntPoint& Cell)
+{
+	FSnakeMoveEvent Event;
+	Event.SnakeId = Snake.Id;
+	Event.Cell = Cell;
+
+	if (!Snake.bAlive || Cell == Snake.Body.GetHead())
+	{
+		return Event;
+	}
+
+	const FSnakeGridCell& Target = GetGridCell(Cell);
+	if (Target.Terrain == ESnakeCell::Wall || Target.Terrain == ESnakeCell::Void)
+	{
+		Snake.bAlive = false;
+		Event.Result = ESnakeMoveResult::HitWall;
+		return Event;
+	}
+
+	const int32 OwnerId = FindBodyOwnerAt(Cell, Snake);
+	if (OwnerId != INDEX_NONE)
+	{
+		Snake.bAlive = false;
+		Event.Result = ESnakeMoveResult::HitSnake;
+		Event.OtherSnakeId = OwnerId;
+		return Event;
+	}
+
+	const bool bAteFood = RemoveFood(Cell);
+
+	// Free the tail first, the head may be moving into the cell it leaves
+	if (Snake.PendingGrowth > 0)
+	{
+		--Snake.PendingGrowth;
+	}
+	else
+	{
+		VacateTail(Snake);
+	}
+	Snake.Body.PushHead(Cell);
+	OccupyCell(Cell, Snake.Id, ++Snake.TilesMoved);
+
+	Event.Result = ESnakeMoveResult::Moved;
+	if (bAteFood)
+	{
+		++Snake.PendingGrowth;
+		Snake.LastGrowthAt = Snake.TilesMoved;
+		Event.Result = ESnakeMoveResult::AteFood;
+	}
+	return Event;
+}
+
+int32 FSnakeSimulation::FindBodyOwnerAt(const FIntPoint& Cell, const FSnakeState& Mover) const
+{
+	const FSnakeGridCell& GridCell = GetGridCell(Cell);
+	if (GridCell.Occupant != ESnakeOccupant::Body)
+	{
+		return INDEX_NONE;
+	}
+
+	if (GridCell.OwnerId == Mover.Id)
+	{
+		// The mover's tail tip moves out of the way this step unless it is growing
+		if (Mover.PendingGrowth == 0 && Cell == Mover.Body.GetTail())
+		{
+			return INDEX_NONE;
+		}
+
+		// A freshly grown segment stays put at the tail tip while the body extends; it is still
+		// in its grace window
+		if (Cell == Mover.Body.GetTail() && Mover.TilesMoved - Mover.LastGrowthAt < uint32(CollisionGraceTiles))
+		{
+			return INDEX_NONE;
+		}
+	}
+	return GridCell.OwnerId;
+}
+
+void FSnakeSimulation::VacateTail(FSnakeState& Snake)
+{
+	const uint32 TailEnteredAt = Snake.TilesMoved - uint32(Snake.Body.Num() - 1);
+	const FIntPoint Tail = Snake.Body.PopTail();
+
+	// A graced move may have put the head back on this cell; it stays occupied until that later
+	// segment becomes the tail
+	const FSnakeGridCell& GridCell = GetGridCell(Tail);
+	if (GridCell.OwnerId == Snake.Id && GridCell.EnteredAt != TailEnteredAt)
+	{
+		return;
+	}
+	VacateCell(Tail, Snake.Id);
+}
+
+bool FSnakeSimulation::SpawnFood(FIntPoint& OutCell)
+{
+	if (FreeSpawnCells.Num() == 0)
+	{
+		return false;
+	}
+
+	const int32 Index = FreeSpawnCells.GetRandom(Random);
+	FreeSpawnCells.Remove(Index);
+	Cells[Index].Occupant = ESnakeOccupant::Food;
+
+	OutCell = FIntPoint(Index % Width, Index / Width);
+	FoodCells.Add(OutCell);
+	++FoodVersion;
+	return true;
+}
+
+void FSnakeSimulation::FindFoodInRadius(const FIntPoint& Center, int32 Radius, TArray<FIntPoint>& OutCells) const
+{
+	// There are only ever a few apples, checking each beats scanning the square around Center
+	const int32 RadiusSquared = Radius * Radius;
+	for (const FIntPoint& Cell : FoodCells)
+	{
+		if ((Cell - Center).SizeSquared() <= RadiusSquared)
+		{
+			OutCells.Add(Cell);
+		}
+	}
+}
+
+bool FSnakeSimulation::RemoveFood(const FIntPoint& Cell)
+{
+	if (!IsInBounds(Cell))
+	{
+		return false;
+	}
+
+	const int32 Index = ToIndex(Cell);
+	FSnakeGridCell& GridCell = Cells[Index];
+	const bool bHadFood = FoodCells.RemoveSingleSwap(Cell) > 0;
+	if (GridCell.Occupant == ESnakeOccupant::Food)
+	{
+		GridCell.Occupant = ESnakeOccupant::None;
+		ReleaseSpawnCell(Index);
+	}
+	if (bHadFood)
+	{
+		++FoodVersion;
+	}
+	return bHadFood;
+}
+
+const FSnakeDistanceField& FSnakeSimulation::GetFoodDistanceField() const
+{
+	if (FoodDistanceFieldVersion != FoodVersion)
+	{
+		if (Terrain.IsValid())
+		{
+			FoodDistanceField.Build(Width, Height, *Terrain, FoodCells);
+		}
+		else
+		{
+			FoodDistanceField.Reset();
+		}
+		FoodDistanceFieldVersion = FoodVersion;
+	}
+	return FoodDistanceField;
+}
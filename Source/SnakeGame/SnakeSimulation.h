@@ -0,0 +1,335 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Definitions.h"
+#include "SnakeDistanceField.h"
+#include "SnakeLevelData.h"
+
+// Plain C++ game rules for the grid: no UObjects, no physics, no actor transforms.
+// ASnakeWorld owns one instance and the pawns only mirror its state, so the same
+// rules can also be stepped headless for balancing and regression runs.
+
+/** Dynamic content of a cell, kept in sync as snakes move and food comes and goes. */
+enum class ESnakeOccupant : uint8
+{
+	None,
+	Food,
+	Body
+};
+
+/** One entry of the occupancy grid. Collision queries are a single read of this. */
+struct FSnakeGridCell
+{
+	ESnakeCell Terrain = ESnakeCell::Void;
+	ESnakeOccupant Occupant = ESnakeOccupant::None;
+
+	// Food may be placed here while the cell is empty
+	bool bFoodSpawn = false;
+
+	// Snake id for Body cells
+	int32 OwnerId = INDEX_NONE;
+
+	// Owner's TilesMoved when its head entered this cell, so the segment's distance from the
+	// head is a subtraction instead of a walk along the body
+	uint32 EnteredAt = 0;
+};
+
+/**
+ * Set of cell indices with O(1) add, remove and uniform random pick: members live in a dense
+ * array and every cell remembers its slot in it, so removal swaps the last member into the hole.
+ */
+class SNAKEGAME_API FSnakeFreeCellSet
+{
+public:
+	void Reset(int32 NumCells)
+	{
+		Members.Reset();
+		Slots.Init(INDEX_NONE, NumCells);
+	}
+
+	int32 Num() const { return Members.Num(); }
+	bool Contains(int32 CellIndex) const { return Slots[CellIndex] != INDEX_NONE; }
+
+	void Add(int32 CellIndex)
+	{
+		if (Slots[CellIndex] == INDEX_NONE)
+		{
+			Slots[CellIndex] = Members.Add(CellIndex);
+		}
+	}
+
+	void Remove(int32 CellIndex)
+	{
+		const int32 Slot = Slots[CellIndex];
+		if (Slot != INDEX_NONE)
+		{
+			const int32 Last = Members.Pop(EAllowShrinking::No);
+			if (Last != CellIndex)
+			{
+				Members[Slot] = Last;
+				Slots[Last] = Slot;
+			}
+			Slots[CellIndex] = INDEX_NONE;
+		}
+	}
+
+	int32 GetRandom(FRandomStream& Random) const
+	{
+		return Members[Random.RandRange(0, Members.Num() - 1)];
+	}
+
+private:
+	TArray<int32> Members;
+	TArray<int32> Slots;
+};
+
+/**
+ * Immutable view of the arena for work off the game thread: the level terrain, shared by every
+ * snapshot of the same level, plus a copy of the cells covered by snake bodies.
+ */
+struct FSnakeGridSnapshot
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	TSharedPtr<const TArray<ESnakeCell>> Terrain;
+
+	// Cell indices (Y * Width + X)
+	TArray<int32> BodyCells;
+};
+
+/** What happened when a snake head entered a cell. */
+enum class ESnakeMoveResult : uint8
+{
+	None,     // Head stayed in the same cell
+	Moved,
+	AteFood,
+	HitWall,
+	HitSnake
+};
+
+struct FSnakeMoveEvent
+{
+	int32 SnakeId = INDEX_NONE;
+	ESnakeMoveResult Result = ESnakeMoveResult::None;
+	FIntPoint Cell = FIntPoint::NoneValue;
+
+	// Owner of the body that was hit, only set for HitSnake
+	int32 OtherSnakeId = INDEX_NONE;
+};
+
+/** A head entering a new cell, collected for every snake before any of them is resolved. */
+struct FSnakeMoveRequest
+{
+	int32 SnakeId = INDEX_NONE;
+	FIntPoint Cell = FIntPoint::NoneValue;
+};
+
+/** Ring buffer of body cells. Index 0 is the head, Num() - 1 the tail tip. */
+class SNAKEGAME_API FSnakeBody
+{
+public:
+	int32 Num() const { return Count; }
+
+	const FIntPoint& operator[](int32 Index) const
+	{
+		check(Index >= 0 && Index < Count);
+		return Cells[(HeadIndex + Index) & (Cells.Num() - 1)];
+	}
+
+	const FIntPoint& GetHead() const { return (*this)[0]; }
+	const FIntPoint& GetTail() const { return (*this)[Count - 1]; }
+
+	void Reset(const FIntPoint& Head);
+	void PushHead(const FIntPoint& Cell);
+	FIntPoint PopTail();
+
+private:
+	void Grow();
+
+	// Capacity is always a power of two so wrapping is a mask
+	TArray<FIntPoint> Cells;
+	int32 HeadIndex = 0;
+	int32 Count = 0;
+};
+
+struct FSnakeState
+{
+	int32 Id = INDEX_NONE;
+	FSnakeBody Body;
+	ESnakeDirection Direction = ESnakeDirection::None;
+
+	// Only consumed by Step(); actor driven snakes pass their cells in directly
+	TArray<ESnakeDirection> DirectionQueue;
+
+	int32 PendingGrowth = 0;
+	bool bAlive = true;
+
+	// Cells the head has entered since the snake was added
+	uint32 TilesMoved = 0;
+
+	// TilesMoved when the snake last ate; the segment that adds stays at the tail tip
+	uint32 LastGrowthAt = 0;
+};
+
+class SNAKEGAME_API FSnakeSimulation
+{
+public:
+	explicit FSnakeSimulation(int32 InSeed = 0);
+
+	// ─── Grid ────────────────────────────────────────────────────────
+	/** Replaces the arena. Snakes are kept where they are, food is cleared. */
+	void SetGrid(const FSnakeLevelData& Level);
+
+	bool HasGrid() const { return Width > 0 && Height > 0; }
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+
+	bool IsInBounds(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	/** Returns Void for cells outside the grid. */
+	ESnakeCell GetCell(const FIntPoint& Cell) const
+	{
+		return IsInBounds(Cell) ? Cells[ToIndex(Cell)].Terrain : ESnakeCell::Void;
+	}
+
+	/** Terrain plus whatever currently stands on the cell; a Void cell for out of bounds. */
+	const FSnakeGridCell& GetGridCell(const FIntPoint& Cell) const
+	{
+		static const FSnakeGridCell OutOfBounds;
+		return IsInBounds(Cell) ? Cells[ToIndex(Cell)] : OutOfBounds;
+	}
+
+	/** Whole grid, row-major, for searches that walk it by index. */
+	const TArray<FSnakeGridCell>& GetGridCells() const { return Cells; }
+
+	/** True for walls, void and any snake body. */
+	bool IsBlocked(const FIntPoint& Cell) const
+	{
+		const FSnakeGridCell& GridCell = GetGridCell(Cell);
+		return GridCell.Terrain == ESnakeCell::Wall
+			|| GridCell.Terrain == ESnakeCell::Void
+			|| GridCell.Occupant == ESnakeOccupant::Body;
+	}
+
+	bool IsWalkable(const FIntPoint& Cell) const
+	{
+		const ESnakeCell Content = GetCell(Cell);
+		return Content == ESnakeCell::Floor || Content == ESnakeCell::Door;
+	}
+
+	const TArray<FIntPoint>& GetFloorCells() const { return FloorCells; }
+
+	/** Cell <-> position relative to the level origin, same layout as the text files. */
+	FVector CellToLocal(const FIntPoint& Cell) const;
+	FIntPoint LocalToCell(const FVector& Local) const;
+
+	/**
+	 * Snapshot of the terrain and body cells, safe to read from any thread. Cached until a body
+	 * moves or the level changes, so every query in a frame shares one copy.
+	 */
+	TSharedRef<const FSnakeGridSnapshot> GetSnapshot() const;
+
+	// ─── Snakes ──────────────────────────────────────────────────────
+	int32 AddSnake(const FIntPoint& Start, ESnakeDirection InDirection = ESnakeDirection::None);
+	void RemoveSnake(int32 SnakeId);
+
+	/** Puts a snake back to a one-cell body at Start, alive and standing still, keeping its id. */
+	void ResetSnake(int32 SnakeId, const FIntPoint& Start);
+
+	const FSnakeState* FindSnake(int32 SnakeId) const;
+	const TArray<FSnakeState>& GetSnakes() const { return Snakes; }
+
+	void QueueDirection(int32 SnakeId, ESnakeDirection InDirection);
+
+	/**
+	 * Grid version of the short collision delay tail pieces used to get after spawning: for that
+	 * many cells after the apple that grew it, the snake's own tail tip never kills it. The rest
+	 * of the body always does. 0 makes every segment lethal.
+	 */
+	void SetCollisionGraceTiles(int32 Tiles) { CollisionGraceTiles = FMath::Max(Tiles, 0); }
+	int32 GetCollisionGraceTiles() const { return CollisionGraceTiles; }
+
+	/** Moves the head of a snake into Cell and resolves food and collisions there. */
+	FSnakeMoveEvent MoveSnakeHead(int32 SnakeId, const FIntPoint& Cell);
+
+	/**
+	 * Resolves moves that happen in the same step, independent of the order they are passed in:
+	 * they are applied by ascending snake id, and two heads entering the same cell both die
+	 * (HitSnake, with OtherSnakeId set to each other). Sorts Requests.
+	 */
+	void ResolveMoves(TArray<FSnakeMoveRequest>& Requests, TArray<FSnakeMoveEvent>& OutEvents);
+
+	/** Advances every living snake by one cell, resolved like ResolveMoves. */
+	void Step(TArray<FSnakeMoveEvent>& OutEvents);
+
+	// ─── Food ────────────────────────────────────────────────────────
+	/** Places food on a random free spawn cell in O(1). Fails only when every candidate is taken. */
+	bool SpawnFood(FIntPoint& OutCell);
+	bool RemoveFood(const FIntPoint& Cell);
+	const TArray<FIntPoint>& GetFoodCells() const { return FoodCells; }
+
+	/** Food within Radius cells of Center (straight-line distance), appended to OutCells. */
+	void FindFoodInRadius(const FIntPoint& Center, int32 Radius, TArray<FIntPoint>& OutCells) const;
+
+	/**
+	 * Walking distance from every cell to the nearest food, shared by all AI snakes. Rebuilt on
+	 * first use after food was placed or eaten, so it costs one BFS per food change.
+	 */
+	const FSnakeDistanceField& GetFoodDistanceField() const;
+
+	static FIntPoint GetDirectionOffset(ESnakeDirection InDirection);
+
+	/** Direction of a single step between two neighbouring cells, None if they are not neighbours. */
+	static ESnakeDirection GetDirectionBetween(const FIntPoint& From, const FIntPoint& To);
+
+private:
+	int32 ToIndex(const FIntPoint& Cell) const { return Cell.Y * Width + Cell.X; }
+
+	FSnakeState* FindSnakeMutable(int32 SnakeId);
+	FSnakeMoveEvent MoveSnake(FSnakeState& Snake, const FIntPoint& Cell);
+
+	/** Id of the snake whose body covers Cell once Mover has moved, or INDEX_NONE. */
+	int32 FindBodyOwnerAt(const FIntPoint& Cell, const FSnakeState& Mover) const;
+
+	void OccupyCell(const FIntPoint& Cell, int32 SnakeId, uint32 EnteredAt);
+	void VacateCell(const FIntPoint& Cell, int32 SnakeId);
+
+	/** Frees the tail tip unless the head has since entered the cell again inside the grace window. */
+	void VacateTail(FSnakeState& Snake);
+
+	/** Puts a cell back into FreeSpawnCells if it is a spawn candidate and now empty. */
+	void ReleaseSpawnCell(int32 CellIndex);
+
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<FSnakeGridCell> Cells;
+	TArray<FIntPoint> FloorCells;
+	TSharedPtr<const TArray<ESnakeCell>> Terrain;
+
+	// Bumped whenever a body cell changes; invalidates CachedSnapshot
+	uint32 BodyVersion = 0;
+	mutable TSharedPtr<const FSnakeGridSnapshot> CachedSnapshot;
+	mutable uint32 CachedSnapshotVersion = 0;
+
+	// Food spawn candidates that currently hold neither food nor a body
+	FSnakeFreeCellSet FreeSpawnCells;
+
+	TArray<FSnakeState> Snakes;
+	int32 NextSnakeId = 0;
+
+	// Reused by Step() and ResolveMoves()
+	TArray<FSnakeMoveRequest> StepRequests;
+	TArray<int32> HeadOnIds;
+	int32 CollisionGraceTiles = 0;
+
+	TArray<FIntPoint> FoodCells;
+	FRandomStream Random;
+
+	// Bumped whenever food is placed or removed; invalidates FoodDistanceField
+	uint32 FoodVersion = 0;
+	mutable FSnakeDistanceField FoodDistanceField;
+	mutable uint32 FoodDistanceFieldVersion = 0;
+};
@@ -0,0 +1,271 @@
+#include "SnakeSurvivalPlanner.h"
+
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	const ESnakeDirection Directions[] = {
+		ESnakeDirection::Up, ESnakeDirection::Right, ESnakeDirection::Down, ESnakeDirection::Left
+	};
+
+	// Finished rollouts first: safe after eating, then able to chase the tail, then the rest
+	int32 GetRank(const FSnakeRollout& Rollout)
+	{
+		if (Rollout.bTimedOut)
+		{
+			return 3;
+		}
+		if (Rollout.bReachedFood && Rollout.bTailReachable)
+		{
+			return 0;
+		}
+		return Rollout.bTailReachable ? 1 : 2;
+	}
+}
+
+void FSnakeBitboard::Init(int32 InWidth, int32 InHeight)
+{
+	Width = InWidth;
+	Height = InHeight;
+	WordsPerRow = (Width + 63) / 64;
+	Bits.Init(0, WordsPerRow * Height);
+}
+
+void FSnakeSurvivalPlanner::BuildBoard(const FSnakeSimulation& Sim)
+{
+	const TSharedRef<const FSnakeGridSnapshot> Snapshot = Sim.GetSnapshot();
+	if (BoardTerrain != Snapshot->Terrain)
+	{
+		BoardTerrain = Snapshot->Terrain;
+		TerrainBoard.Init(Snapshot->Width, Snapshot->Height);
+
+		const TArray<ESnakeCell>& Terrain = *Snapshot->Terrain;
+		for (int32 Y = 0; Y < Snapshot->Height; ++Y)
+		{
+			for (int32 X = 0; X < Snapshot->Width; ++X)
+			{
+				const ESnakeCell Cell = Terrain[Y * Snapshot->Width + X];
+				if (Cell != ESnakeCell::Floor && Cell != ESnakeCell::Door)
+				{
+					TerrainBoard.Set(FIntPoint(X, Y));
+				}
+			}
+		}
+	}
+
+	Base = TerrainBoard;
+	for (const int32 BodyIndex : Snapshot->BodyCells)
+	{
+		Base.Set(FIntPoint(BodyIndex % Snapshot->Width, BodyIndex / Snapshot->Width));
+	}
+}
+
+ESnakeDirection FSnakeSurvivalPlanner::ChooseDirection(const FSnakeSimulation& Sim, int32 SnakeId, const FIntPoint& Goal,
+	ESnakeDirection Preferred, ESnakeDirection Current, int32 BudgetMicroseconds)
+{
+	Rollouts.Reset();
+
+	const FSnakeState* Snake = Sim.FindSnake(SnakeId);
+	if (!Snake || Snake->Body.Num() == 0 || !Sim.HasGrid() || BudgetMicroseconds <= 0)
+	{
+		return Preferred;
+	}
+
+	// Copying the board is part of the decision, so the clock starts before it
+	const uint64 Deadline = FPlatformTime::Cycles64()
+		+ uint64(BudgetMicroseconds * 1e-6 / FPlatformTime::GetSecondsPerCycle64());
+	BuildBoard(Sim);
+
+	// The tail tip moves away this step unless the snake is still growing
+	const FIntPoint Head = Snake->Body.GetHead();
+	const FIntPoint Forward = FSnakeSimulation::GetDirectionOffset(Current);
+	const bool bTailMoves = Snake->PendingGrowth == 0 && Snake->Body.Num() > 1;
+	for (const ESnakeDirection Dir : Directions)
+	{
+		const FIntPoint Offset = FSnakeSimulation::GetDirectionOffset(Dir);
+		const FIntPoint Next = Head + Offset;
+		if (Current != ESnakeDirection::None && Offset + Forward == FIntPoint::ZeroValue)
+		{
+			continue;
+		}
+		if (!Base.Test(Next) || (bTailMoves && Next == Snake->Body.GetTail()))
+		{
+			Rollouts.AddDefaulted_GetRef().Direction = Dir;
+		}
+	}
+
+	if (Rollouts.Num() < 2)
+	{
+		return Rollouts.Num() == 1 ? Rollouts[0].Direction : Preferred;
+	}
+
+	Scratch.SetNum(FMath::Max(Scratch.Num(), Rollouts.Num()));
+	ParallelFor(Rollouts.Num(), [this, Snake, &Goal, Deadline](int32 Index)
+	{
+		Rollout(Base, *Snake, Goal, Deadline, Scratch[Index], Rollouts[Index]);
+	});
+
+	// Lowest rank wins; more room breaks ties for trapped moves, then Preferred, then the shorter way
+	const FSnakeRollout* Best = nullptr;
+	auto IsBetter = [Preferred](const FSnakeRollout& A, const FSnakeRollout& B)
+	{
+		const int32 RankA = GetRank(A);
+		const int32 RankB = GetRank(B);
+		if (RankA != RankB)
+		{
+			return RankA < RankB;
+		}
+		if (RankA == 2 && A.FreeArea != B.FreeArea)
+		{
+			return A.FreeArea > B.FreeArea;
+		}
+		if ((A.Direction == Preferred) != (B.Direction == Preferred))
+		{
+			return A.Direction == Preferred;
+		}
+		return A.Steps < B.Steps;
+	};
+	for (const FSnakeRollout& Candidate : Rollouts)
+	{
+		if (!Best || IsBetter(Candidate, *Best))
+		{
+			Best = &Candidate;
+		}
+	}
+	return Best->Direction;
+}
+
+void FSnakeSurvivalPlanner::Rollout(const FSnakeBitboard& Base, const FSnakeState& Snake, const FIntPoint& Goal,
+	uint64 Deadline, FScratch& Scratch, FSnakeRollout& Out)
+{
+	Scratch.Board = Base;
+	Scratch.Body.Reset();
+	for (int32 i = Snake.Body.Num() - 1; i >= 0; --i)
+	{
+		Scratch.Body.Add(Snake.Body[i]);
+	}
+
+	int32 TailIndex = 0;
+	int32 Growth = Snake.PendingGrowth;
+	auto Advance = [&](const FIntPoint& Next)
+	{
+		if (Growth > 0)
+		{
+			--Growth;
+		}
+		else
+		{
+			Scratch.Board.Clear(Scratch.Body[TailIndex++]);
+		}
+		Scratch.Board.Set(Next);
+		Scratch.Body.Add(Next);
+		++Out.Steps;
+
+		if (Next == Goal)
+		{
+			++Growth;
+			Out.bReachedFood = true;
+		}
+	};
+
+	Advance(Scratch.Body.Last() + FSnakeSimulation::GetDirectionOffset(Out.Direction));
+
+	// Other snakes stay where they are, which only makes the check more cautious
+	bool bFound = false;
+	if (!Out.bReachedFood)
+	{
+		Search(Scratch, Scratch.Body.Last(), Goal, MAX_int32, true, Deadline, bFound, Out.bTimedOut);
+		for (int32 i = 1; bFound && i < Scratch.Path.Num(); ++i)
+		{
+			Advance(Scratch.Path[i]);
+		}
+	}
+	if (Out.bTimedOut)
+	{
+		return;
+	}
+
+	const FIntPoint Head = Scratch.Body.Last();
+	const FIntPoint Tail = Scratch.Body[TailIndex];
+	const int32 Length = Scratch.Body.Num() - TailIndex;
+	if (Length == 1)
+	{
+		Out.bTailReachable = true;
+		return;
+	}
+
+	Out.FreeArea = Search(Scratch, Head, Tail, Length, false, Deadline, Out.bTailReachable, Out.bTimedOut);
+}
+
+int32 FSnakeSurvivalPlanner::Search(FScratch& Scratch, const FIntPoint& From, const FIntPoint& To, int32 AreaLimit,
+	bool bBuildPath, uint64 Deadline, bool& bOutFound, bool& bOutTimedOut)
+{
+	const FSnakeBitboard& Board = Scratch.Board;
+	const int32 Width = Board.Width;
+	bOutFound = false;
+	Scratch.Path.Reset();
+
+	if (Scratch.Seen.Width != Board.Width || Scratch.Seen.Height != Board.Height)
+	{
+		Scratch.Seen.Init(Board.Width, Board.Height);
+		Scratch.Parent.SetNumUninitialized(Board.Width * Board.Height);
+	}
+	else
+	{
+		FMemory::Memzero(Scratch.Seen.Bits.GetData(), Scratch.Seen.Bits.Num() * sizeof(uint64));
+	}
+
+	Scratch.Queue.Reset();
+	Scratch.Queue.Add(From.Y * Width + From.X);
+	Scratch.Seen.Set(From);
+	Scratch.Parent[From.Y * Width + From.X] = INDEX_NONE;
+
+	int32 Visited = 0;
+	for (int32 Read = 0; Read < Scratch.Queue.Num(); ++Read)
+	{
+		// The clock is not free, look at it every few cells only
+		if ((Read & 63) == 63 && FPlatformTime::Cycles64() >= Deadline)
+		{
+			bOutTimedOut = true;
+			return Visited;
+		}
+
+		const int32 Index = Scratch.Queue[Read];
+		const FIntPoint Cell(Index % Width, Index / Width);
+		if (Cell == To)
+		{
+			bOutFound = true;
+			if (bBuildPath)
+			{
+				for (int32 At = Index; At != INDEX_NONE; At = Scratch.Parent[At])
+				{
+					Scratch.Path.Add(FIntPoint(At % Width, At / Width));
+				}
+				Algo::Reverse(Scratch.Path);
+			}
+			return Visited;
+		}
+
+		if (++Visited >= AreaLimit)
+		{
+			return Visited;
+		}
+
+		for (const ESnakeDirection Dir : Directions)
+		{
+			const FIntPoint Next = Cell + FSnakeSimulation::GetDirectionOffset(Dir);
+			if (!Board.IsInBounds(Next) || Scratch.Seen.Test(Next) || (Board.Test(Next) && Next != To))
+			{
+				continue;
+			}
+
+			Scratch.Seen.Set(Next);
+			Scratch.Parent[Next.Y * Width + Next.X] = Index;
+			Scratch.Queue.Add(Next.Y * Width + Next.X);
+		}
+	}
+
+	return Visited;
+}
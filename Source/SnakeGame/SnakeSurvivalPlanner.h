@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SnakeSimulation.h"
+
+/**
+ * One bit per cell, set where a snake cannot go. Rows start on a new 64-bit word, the same
+ * layout as FSnakeLevelData::InteriorMask, so copying a whole board is a single memcpy.
+ */
+struct SNAKEGAME_API FSnakeBitboard
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 WordsPerRow = 0;
+	TArray<uint64> Bits;
+
+	void Init(int32 InWidth, int32 InHeight);
+
+	bool IsInBounds(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	/** Cells outside the board count as blocked. */
+	bool Test(const FIntPoint& Cell) const
+	{
+		return !IsInBounds(Cell) || (Bits[Cell.Y * WordsPerRow + Cell.X / 64] >> (Cell.X % 64)) & 1;
+	}
+
+	void Set(const FIntPoint& Cell) { Bits[Cell.Y * WordsPerRow + Cell.X / 64] |= uint64(1) << (Cell.X % 64); }
+	void Clear(const FIntPoint& Cell) { Bits[Cell.Y * WordsPerRow + Cell.X / 64] &= ~(uint64(1) << (Cell.X % 64)); }
+};
+
+/** What happened when one first move was played forward. */
+struct FSnakeRollout
+{
+	ESnakeDirection Direction = ESnakeDirection::None;
+
+	// Got to the food, and after eating it the head could still find a way to the tail
+	bool bReachedFood = false;
+	bool bTailReachable = false;
+
+	// The decision budget ran out before the rollout finished, the flags above are incomplete
+	bool bTimedOut = false;
+
+	int32 Steps = 0;
+
+	// Cells the head could still reach when the tail could not be, capped at the body length
+	int32 FreeArea = 0;
+};
+
+/**
+ * Checks the AI's next move by playing it forward on a bitboard copy of the arena: walk the
+ * shortest way to the food, eat, then make sure the head can still reach its own tail. Each
+ * candidate first move is rolled out on its own worker with ParallelFor.
+ *
+ * All rollouts share one deadline, so the budget given to ChooseDirection bounds the CPU time
+ * of a decision; rollouts cut short by it rank below every finished one.
+ */
+class SNAKEGAME_API FSnakeSurvivalPlanner
+{
+public:
+	/**
+	 * Move for SnakeId towards Goal. Preferred is kept when it is as safe as any alternative,
+	 * otherwise the safest neighbour wins. Returns Preferred when there is nothing to choose from.
+	 */
+	ESnakeDirection ChooseDirection(const FSnakeSimulation& Sim, int32 SnakeId, const FIntPoint& Goal,
+		ESnakeDirection Preferred, ESnakeDirection Current, int32 BudgetMicroseconds);
+
+	/** Rollouts of the last decision, for debugging. */
+	const TArray<FSnakeRollout>& GetLastRollouts() const { return Rollouts; }
+
+private:
+	// Per rollout working set, kept between decisions so a rollout allocates nothing
+	struct FScratch
+	{
+		FSnakeBitboard Board;
+		FSnakeBitboard Seen;
+		TArray<int32> Queue;
+		TArray<int32> Parent;
+		TArray<FIntPoint> Path;
+
+		// Own body, tail first; the live part starts at the rollout's tail index
+		TArray<FIntPoint> Body;
+	};
+
+	/** Rebuilds Base from the simulation; the terrain part is only redone when the level changed. */
+	void BuildBoard(const FSnakeSimulation& Sim);
+
+	static void Rollout(const FSnakeBitboard& Base, const FSnakeState& Snake, const FIntPoint& Goal,
+		uint64 Deadline, FScratch& Scratch, FSnakeRollout& Out);
+
+	/**
+	 * Breadth-first search on Scratch.Board from From. Stops at To, which may itself be blocked,
+	 * or after visiting AreaLimit cells. Returns the number of cells visited; bOutFound tells
+	 * whether To was reached, and Scratch.Path holds the way there when bBuildPath is set.
+	 */
+	static int32 Search(FScratch& Scratch, const FIntPoint& From, const FIntPoint& To, int32 AreaLimit,
+		bool bBuildPath, uint64 Deadline, bool& bOutFound, bool& bOutTimedOut);
+
+	FSnakeBitboard TerrainBoard;
+	TSharedPtr<const TArray<ESnakeCell>> BoardTerrain;
+	FSnakeBitboard Base;
+
+	TArray<FSnakeRollout> Rollouts;
+	TArray<FScratch> Scratch;
+};
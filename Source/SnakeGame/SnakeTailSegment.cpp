@@ -1,29 +0,0 @@
-#include "SnakeTailSegment.h"
-#include "Components/StaticMeshComponent.h"
-#include "UObject/ConstructorHelpers.h"
-
-ASnakeTailSegment::ASnakeTailSegment()
-{
-	PrimaryActorTick.bCanEverTick = false;
-
-	MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComponent"));
-	RootComponent = MeshComponent;
-	
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube"));
-	if (CubeMesh.Succeeded())
-	{
-		MeshComponent->SetStaticMesh(CubeMesh.Object);
-	}
-	else
-	{
-		UE_LOG(LogTemp, Error, TEXT("Cube mesh not found!"));
-	}
-	
-	MeshComponent->SetWorldScale3D(FVector(0.5f));
-	
-	MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	MeshComponent->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
-	MeshComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-	
-	bCanCollide = false;
-}
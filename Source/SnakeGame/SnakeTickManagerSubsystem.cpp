@@ -0,0 +1,127 @@
+#include "SnakeTickManagerSubsystem.h"
+
+#include "Definitions.h"
+#include "SnakeActorRegistry.h"
+#include "SnakeAIManagerSubsystem.h"
+#include "SnakeGameMode.h"
+#include "SnakePawn.h"
+#include "SnakeWorld.h"
+
+TStatId USnakeTickManagerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USnakeTickManagerSubsystem, STATGROUP_Tickables);
+}
+
+bool USnakeTickManagerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USnakeTickManagerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this);
+	if (!Registry || Registry->GetSnakes().Num() == 0)
+	{
+		Accumulator = 0.0;
+		return;
+	}
+	ASnakeWorld* World = Registry->GetSnakeWorld();
+
+	const int32 StepsPerSecond = World ? FMath::Max(World->SimulationStepsPerSecond, 1) : DefaultStepsPerSecond;
+	const double StepSeconds = 1.0 / StepsPerSecond;
+	const int32 TileUnits = FMath::RoundToInt32(TileSize) * StepsPerSecond;
+
+	Snakes.Reset();
+	for (ASnakePawn* Snake : Registry->GetSnakes())
+	{
+		if (IsValid(Snake))
+		{
+			Snakes.Add(Snake);
+		}
+	}
+	Snakes.Sort([](const ASnakePawn& A, const ASnakePawn& B) { return A.SnakeId < B.SnakeId; });
+
+	Accumulator += DeltaTime;
+	int32 Steps = FMath::FloorToInt32(Accumulator / StepSeconds);
+	if (Steps > MaxStepsPerFrame)
+	{
+		Steps = MaxStepsPerFrame;
+		Accumulator = Steps * StepSeconds;
+	}
+	Accumulator -= Steps * StepSeconds;
+
+	for (int32 i = 0; i < Steps; ++i)
+	{
+		Step(World, StepSeconds, TileUnits);
+
+		// Game over or a menu paused the game, the rest of this frame's steps wait for it
+		if (GetWorld()->IsPaused())
+		{
+			Accumulator = 0.0;
+			break;
+		}
+	}
+
+	const float Alpha = float(Accumulator / StepSeconds);
+	for (ASnakePawn* Snake : Snakes)
+	{
+		Snake->RenderStep(Alpha);
+	}
+}
+
+void USnakeTickManagerSubsystem::Step(ASnakeWorld* World, float StepSeconds, int32 TileUnits)
+{
+	// Deaths and finished levels are only collected while the step's events play out
+	ASnakeGameMode* GameMode = Cast<ASnakeGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode)
+	{
+		GameMode->BeginSnakeStep();
+	}
+
+	Requests.Reset();
+	for (ASnakePawn* Snake : Snakes)
+	{
+		FIntPoint Cell;
+		if (Snake->StepMovement(StepSeconds, TileUnits, Cell))
+		{
+			Requests.Add({ Snake->SnakeId, Cell });
+		}
+	}
+
+	// Tiles entered in the same step are resolved together, whatever order they came in
+	if (Requests.Num() > 0 && World)
+	{
+		Events.Reset();
+		World->GetSimulation().ResolveMoves(Requests, Events);
+
+		const USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this);
+		for (const FSnakeMoveEvent& Event : Events)
+		{
+			if (ASnakePawn* Snake = Registry->FindSnake(Event.SnakeId))
+			{
+				Snake->EnterTile(Event);
+			}
+		}
+	}
+
+	for (ASnakePawn* Snake : Snakes)
+	{
+		Snake->FinishStep(TileUnits);
+	}
+
+	// At most one game over or level change, once the whole step is on the grid it was resolved on
+	if (GameMode)
+	{
+		GameMode->EndSnakeStep();
+	}
+
+	if (World)
+	{
+		if (USnakeAIManagerSubsystem* AIManager = GetWorld()->GetSubsystem<USnakeAIManagerSubsystem>())
+		{
+			AIManager->UpdateControllers(*World);
+		}
+	}
+}
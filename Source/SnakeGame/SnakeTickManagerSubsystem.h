@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SnakeSimulation.h"
+#include "SnakeTickManagerSubsystem.generated.h"
+
+class ASnakePawn;
+class ASnakeWorld;
+
+/**
+ * Advances every snake of a world from one tick, in a fixed order: movement for all snakes, with
+ * the tiles they enter resolved together by the simulation; then the game over or level change
+ * that step caused, if any; then AI decisions; then the tails.
+ * Snakes are always handled by ascending simulation id, so two runs with the same inputs play out
+ * the same way. Snake pawns, AI controllers and ASnakeWorld do not tick themselves.
+ *
+ * Game logic runs in fixed steps (ASnakeWorld::SimulationStepsPerSecond) with integer progress
+ * along the tiles, so its cost per second and its outcome do not depend on the frame rate; each
+ * frame then draws the snakes between their last two steps.
+ */
+UCLASS()
+class SNAKEGAME_API USnakeTickManagerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** One logic step of every snake, then its outcome for the game mode, then the AI. */
+	void Step(ASnakeWorld* World, float StepSeconds, int32 TileUnits);
+
+	// Used while no ASnakeWorld is around to configure it
+	static constexpr int32 DefaultStepsPerSecond = 60;
+
+	// After a hitch the snakes catch up at most this many steps in one frame and drop the rest,
+	// so a slow frame cannot make the next one slower still
+	static constexpr int32 MaxStepsPerFrame = 8;
+
+	// Time not yet consumed by a whole step
+	double Accumulator = 0.0;
+
+	// Reused every frame, ordered by snake id
+	TArray<ASnakePawn*> Snakes;
+	TArray<FSnakeMoveRequest> Requests;
+	TArray<FSnakeMoveEvent> Events;
+};
@@ -2,33 +2,37 @@
 
 #include "Definitions.h"
 #include "Engine/World.h"
+#include "SnakeActorRegistry.h"
 #include "SnakeFood.h"
-#include "Misc/FileHelper.h"
-#include "Misc/Paths.h"
+#include "SnakeLevelData.h"
 
 ASnakeWorld::ASnakeWorld()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Snakes are stepped by USnakeTickManagerSubsystem, the world only answers their queries
+    PrimaryActorTick.bCanEverTick = false;
     
     RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("SceneComponent"));
     
     InstancedWalls = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("InstancedWalls"));
     InstancedWalls->SetupAttachment(RootComponent);
-    InstancedWalls->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-    InstancedWalls->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
-    InstancedWalls->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+    // Wall hits are answered by the simulation grid, keep the instances out of the physics scene
+    InstancedWalls->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    InstancedWalls->SetGenerateOverlapEvents(false);
     InstancedWalls->ComponentTags.Empty();
     InstancedWalls->ComponentTags.Add(FName("Wall"));
     
     InstancedFloors = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("InstancedFloors"));
     InstancedFloors->SetupAttachment(RootComponent);
+    InstancedFloors->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    InstancedFloors->SetGenerateOverlapEvents(false);
 }
 
 void ASnakeWorld::OnConstruction(const FTransform& Transform)
 {
     UE_LOG(LogTemp, Log, TEXT("OnConstruction Called!"));
 
-    // Clean up previous instances and spawned actors
+    // Clean up previous instances and spawned actors; construction reruns on every edit,
+    // so nothing is kept pooled in the editor
     InstancedWalls->ClearInstances();
     InstancedFloors->ClearInstances();
     for (AActor* Actor : SpawnedActors)
@@ -39,14 +43,12 @@ void ASnakeWorld::OnConstruction(const FTransform& Transform)
         }
     }
     SpawnedActors.Empty();
-    
-    // Clear previous floor tile locations.
-    FloorTileLocations.Empty();
+    FoodPool.Empty();
+    DoorPool.Empty();
 
 
-    InstancedWalls->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-    InstancedWalls->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
-    InstancedWalls->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+    InstancedWalls->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    InstancedWalls->SetGenerateOverlapEvents(false);
     if (!InstancedWalls->ComponentTags.Contains(FName("Wall")))
     {
         InstancedWalls->ComponentTags.Empty();
@@ -55,131 +57,239 @@ void ASnakeWorld::OnConstruction(const FTransform& Transform)
     LoadLevelFromText();
 }
 
-void ASnakeWorld::BeginPlay()
+void ASnakeWorld::PostInitializeComponents()
 {
-    Super::BeginPlay();
-    SpawnFood();
+    Super::PostInitializeComponents();
+
+    // Before any BeginPlay, so snakes starting in the same frame can already find us
+    if (USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this))
+    {
+        Registry->RegisterWorld(this);
+    }
 }
 
-void ASnakeWorld::Tick(float DeltaTime)
+void ASnakeWorld::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    Super::Tick(DeltaTime);
+    if (USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this))
+    {
+        Registry->UnregisterWorld(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASnakeWorld::BeginPlay()
+{
+    Super::BeginPlay();
+    
+    Simulation.SetCollisionGraceTiles(CollisionGraceTiles);
+    StartLevelIndex = LevelIndex;
+
+    // Level placed worlds keep their instances from the editor, but the grid is not serialized
+    if (!Simulation.HasGrid())
+    {
+        LoadLevelFromText();
+    }
+    SpawnFood();
 }
 
 bool ASnakeWorld::DoesLevelExist(int32 Index) const
 {
-    const FString FileName = FString::Printf(TEXT("Levels/Level%d.txt"), Index);
-    const FString FullPath = FPaths::ProjectContentDir() / FileName;
-    return FPlatformFileManager::Get().GetPlatformFile().FileExists(*FullPath);
+    return FSnakeLevelData::Exists(Index);
 }
 
-void ASnakeWorld::LoadLevelFromText()
+bool ASnakeWorld::LoadLevelFromText()
 {
+    UE_LOG(LogTemp, Warning, TEXT("[LevelLoad] Attempting to load level %d"), LevelIndex);
+    
+    const TSharedPtr<FSnakePreparedLevel> Prepared = TakePreparedLevel(LevelIndex);
+    if (!Prepared->bLoaded)
+    {
+        // Nothing is torn down yet, so the previous level stays exactly as it was, drawn and simulated
+        UE_LOG(LogTemp, Error, TEXT("[LevelLoad] Failed to load file!"));
+        return false;
+    }
+
     InstancedWalls->ClearInstances();
     InstancedFloors->ClearInstances();
-    for (AActor* Actor : SpawnedActors)
+    ReleaseDoors();
+    ClearFood();
+
+    const FSnakeLevelData& Level = Prepared->Level;
+    UE_LOG(LogTemp, Warning, TEXT("[LevelLoad] Loaded %dx%d cells"), Level.Width, Level.Height);
+
+    // Only prewarm in play, editor construction would leave hidden pooled actors in the level
+    if (GetWorld() && GetWorld()->IsGameWorld())
     {
-        if (Actor)
+        const FSnakePoolPrewarm* Prewarm = PoolPrewarmByLevel.Find(LevelIndex);
+        if (!Prewarm)
         {
-            Actor->Destroy();
+            Prewarm = &DefaultPoolPrewarm;
         }
+        FoodPool.Prewarm(GetWorld(), FoodClass, Prewarm->Food);
+        DoorPool.Prewarm(GetWorld(), DoorActor, FMath::Max(Prewarm->Doors, Level.DoorCells.Num()));
     }
-    SpawnedActors.Empty();
-    FloorTileLocations.Empty();
 
-    FString FileName = FString::Printf(TEXT("Levels/Level%d.txt"), LevelIndex);
-    FString FilePath = FPaths::ProjectContentDir() + FileName;
-    UE_LOG(LogTemp, Warning, TEXT("[LevelLoad] Attempting to load: %s"), *FilePath);
-    
-    TArray<FString> Lines;
+    ApplyPreparedLevel(*Prepared);
 
-    if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+    // Parse the next level while this one is played, so finishing it does not hitch
+    if (bPreloadNextLevel && GetWorld() && GetWorld()->IsGameWorld())
     {
-        UE_LOG(LogTemp, Error, TEXT("[LevelLoad] Failed to load file!"));
-        return;
+        PreloadLevel(LevelIndex + 1);
     }
-    UE_LOG(LogTemp, Warning, TEXT("[LevelLoad] Loaded %d lines"), Lines.Num());
-    
-    if (FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+    return true;
+}
+
+void ASnakeWorld::ApplyPreparedLevel(const FSnakePreparedLevel& Prepared)
+{
+    for (const FTransform& Transform : Prepared.DoorTransforms)
     {
-        int y = 0;
-        for (const FString& Line : Lines)
+        if (IsValid(DoorActor))
         {
-            for (int x = 0; x < Line.Len(); x++)
+            AActor* SpawnedActor = DoorPool.Acquire(GetWorld(), DoorActor, Transform);
+            if (SpawnedActor)
             {
-                FTransform TileTransform(FRotator::ZeroRotator, FVector((Lines.Num() - y) * 100, x * 100, 0.0f));
-                
-                switch (Line[x])
-                {
-                    case '#':
-                        InstancedWalls->AddInstance(TileTransform);
-                        break;
-
-                    case 'O':
-                        break;
-
-                    case 'D':
-                        InstancedFloors->AddInstance(TileTransform);
-                        if (IsValid(DoorActor))
-                        {
-                            AActor* SpawnedActor = GetWorld()->SpawnActor<AActor>(DoorActor, TileTransform, FActorSpawnParameters());
-                            if (SpawnedActor)
-                            {
-                                SpawnedActor->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
-                                SpawnedActors.Add(SpawnedActor);
-                            }
-                        }
-                        break;
-
-                    case '.':
-                        InstancedFloors->AddInstance(TileTransform);
-                        FloorTileLocations.Add(TileTransform.GetTranslation());
-                        break;
-                }
+                // Pooled doors may still be attached from the last level, so set the
+                // relative transform explicitly instead of relying on the attach
+                SpawnedActor->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+                SpawnedActor->SetActorRelativeTransform(Transform);
+                SpawnedActors.Add(SpawnedActor);
             }
-            y++;
         }
-    } 
+    }
+    
+    // One batched add per component instead of one render state update per tile
+    InstancedWalls->AddInstances(Prepared.WallTransforms, false);
+    InstancedFloors->AddInstances(Prepared.FloorTransforms, false);
+    
+    Simulation.SetGrid(Prepared.Level);
+}
+
+void ASnakeWorld::PreloadLevel(int32 Index)
+{
+    if ((Index == PreloadIndex && PreloadTask.IsValid()) || LevelCache.Contains(Index))
+    {
+        return;
+    }
+
+    // The task only owns its result, an abandoned preload simply finishes unused
+    PreloadIndex = Index;
+    PreloadTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Index]()
+    {
+        return TSharedPtr<FSnakePreparedLevel>(FSnakePreparedLevel::Prepare(Index));
+    });
+}
+
+TSharedPtr<FSnakePreparedLevel> ASnakeWorld::TakePreparedLevel(int32 Index)
+{
+    if (const TSharedPtr<FSnakePreparedLevel>* Cached = LevelCache.Find(Index))
+    {
+        return *Cached;
+    }
+
+    TSharedPtr<FSnakePreparedLevel> Prepared;
+    if (Index == PreloadIndex && PreloadTask.IsValid())
+    {
+        // Normally done long ago; waits only if the level is finished faster than it parses
+        Prepared = PreloadTask.GetResult();
+        PreloadTask = {};
+        PreloadIndex = INDEX_NONE;
+    }
+    else
+    {
+        Prepared = FSnakePreparedLevel::Prepare(Index);
+    }
+
+    // Only cache in play, the editor reparses so edits to the level files show up
+    if (Prepared->bLoaded && GetWorld() && GetWorld()->IsGameWorld())
+    {
+        LevelCache.Add(Index, Prepared);
+    }
+    return Prepared;
 }
 
 void ASnakeWorld::SpawnFood()
 {
-    if (!FoodClass || FloorTileLocations.Num() == 0)
+    if (!FoodClass)
+        return;
+    
+    // The registry remembers which actor stands on which cell, so eaten food can be handed back
+    USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this);
+    if (!Registry)
         return;
     
-    TSet<FVector> FloorSet(FloorTileLocations);
-    TArray<FVector> ValidSpawnTiles;
-    FVector Offsets[4] = {
-        FVector(TileSize,  0,       0),
-        FVector(-TileSize, 0,       0),
-        FVector(0,        TileSize, 0),
-        FVector(0,       -TileSize, 0)
-    };
-
-    for (const FVector& Loc : FloorTileLocations)
-    {
-        bool bSurrounded = true;
-        for (auto& Offset : Offsets)
+    FIntPoint Cell;
+    if (!Simulation.SpawnFood(Cell))
+        return;
+    
+    Registry->RegisterFood(Cell, FoodPool.Acquire(GetWorld(), FoodClass, FTransform(CellToWorld(Cell))));
+}
+
+void ASnakeWorld::ConsumeFood(const FIntPoint& Cell)
+{
+    Simulation.RemoveFood(Cell);
+    
+    if (USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this))
+    {
+        FoodPool.Release(Registry->UnregisterFood(Cell));
+    }
+}
+
+void ASnakeWorld::ClearFood()
+{
+    if (USnakeActorRegistry* Registry = USnakeActorRegistry::Get(this))
+    {
+        for (const TPair<FIntPoint, AActor*>& Pair : Registry->GetFoods())
         {
-            FVector Neigh = SnapToGrid(Loc + Offset);
-            if (!FloorSet.Contains(Neigh))
-            {
-                bSurrounded = false;
-                break;
-            }
+            FoodPool.Release(Pair.Value);
         }
+        Registry->UnregisterAllFood();
+    }
+}
+
+void ASnakeWorld::ReleaseDoors()
+{
+    for (AActor* Actor : SpawnedActors)
+    {
+        DoorPool.Release(Actor);
+    }
+    SpawnedActors.Empty();
+}
 
-        if (bSurrounded)
-            ValidSpawnTiles.Add(Loc);
+int32 ASnakeWorld::RegisterSnake(const FVector& WorldLocation)
+{
+    if (!Simulation.HasGrid())
+    {
+        LoadLevelFromText();
     }
-    
-    const TArray<FVector>& Pool = (ValidSpawnTiles.Num() > 0)
-        ? ValidSpawnTiles
-        : FloorTileLocations;
-    
-    int32 Index = FMath::RandRange(0, Pool.Num() - 1);
-    FVector Chosen = Pool[Index];
-    FVector SpawnLocation = GetActorLocation() + Chosen;
-    GetWorld()->SpawnActor<AActor>(FoodClass, SpawnLocation, FRotator::ZeroRotator);
+    return Simulation.AddSnake(WorldToCell(WorldLocation));
 }
 
+void ASnakeWorld::UnregisterSnake(int32 SnakeId)
+{
+    Simulation.RemoveSnake(SnakeId);
+}
+
+void ASnakeWorld::ResetSnake(int32 SnakeId, const FVector& WorldLocation)
+{
+    Simulation.ResetSnake(SnakeId, WorldToCell(WorldLocation));
+}
+
+void ASnakeWorld::ResetToStartLevel()
+{
+    if (StartLevelIndex != INDEX_NONE)
+    {
+        LevelIndex = StartLevelIndex;
+    }
+    LoadLevelFromText();
+}
+
+FVector ASnakeWorld::CellToWorld(const FIntPoint& Cell) const
+{
+    return GetActorLocation() + Simulation.CellToLocal(Cell);
+}
+
+FIntPoint ASnakeWorld::WorldToCell(const FVector& WorldLocation) const
+{
+    return Simulation.LocalToCell(WorldLocation - GetActorLocation());
+}
@@ -3,8 +3,25 @@
 #include "CoreMinimal.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "GameFramework/Actor.h"
+#include "SnakeActorPool.h"
+#include "SnakePreparedLevel.h"
+#include "SnakeSimulation.h"
+#include "Tasks/Task.h"
 #include "SnakeWorld.generated.h"
 
+/** How many actors of each pooled kind to create ahead of time when a level loads. */
+USTRUCT(BlueprintType)
+struct FSnakePoolPrewarm
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0"))
+	int32 Food = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0"))
+	int32 Doors = 0;
+};
+
 UCLASS()
 class SNAKEGAME_API ASnakeWorld : public AActor
 {
@@ -30,6 +47,13 @@ public:
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Food")
 	float FoodSpawnDelay = 0.5f;
+
+	/** Pool sizes for levels without an entry in PoolPrewarmByLevel. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pooling")
+	FSnakePoolPrewarm DefaultPoolPrewarm;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pooling")
+	TMap<int32, FSnakePoolPrewarm> PoolPrewarmByLevel;
 	
 	UPROPERTY()
 	TArray<AActor*> SpawnedActors;
@@ -41,20 +65,87 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Level")
 	int32 LevelIndex = 1;
+
+	/** Fixed rate game logic runs at; snakes are drawn in between steps. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Simulation", meta=(ClampMin="10", ClampMax="240"))
+	int32 SimulationStepsPerSecond = 60;
+
+	/** Cells a snake moves after eating before its newly grown tail segment can kill it (0.3 s at the default speed). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Collision", meta=(ClampMin="0"))
+	int32 CollisionGraceTiles = 2;
 	
+	/** Builds LevelIndex. Returns false and leaves the current level untouched when it cannot be loaded. */
 	UFUNCTION(BlueprintCallable, Category="Level")
-	void LoadLevelFromText();
+	bool LoadLevelFromText();
 	
 	UFUNCTION(BlueprintCallable, Category="Level")
 	bool DoesLevelExist(int32 Index) const;
 
+	/** Load and lay out LevelIndex + 1 on a worker while this level is played. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Level")
+	bool bPreloadNextLevel = true;
+
+	// ─── Simulation ──────────────────────────────────────────────────
+	FSnakeSimulation& GetSimulation() { return Simulation; }
+	const FSnakeSimulation& GetSimulation() const { return Simulation; }
+
+	/** Adds a snake to the simulation at the cell under WorldLocation and returns its id. */
+	int32 RegisterSnake(const FVector& WorldLocation);
+	void UnregisterSnake(int32 SnakeId);
+
+	/** Moves a registered snake back to a single cell under WorldLocation. */
+	void ResetSnake(int32 SnakeId, const FVector& WorldLocation);
+
+	/**
+	 * Soft restart: reloads the level the world started on from the parsed-level cache. Snakes
+	 * are reset by their pawns afterwards, then food is spawned as usual.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Level")
+	void ResetToStartLevel();
+
+	FVector CellToWorld(const FIntPoint& Cell) const;
+	FIntPoint WorldToCell(const FVector& WorldLocation) const;
+
+	/** Removes the food actor standing on Cell once the simulation reports it eaten. */
+	void ConsumeFood(const FIntPoint& Cell);
+
 protected:
+	virtual void PostInitializeComponents() override;
 	virtual void BeginPlay() override;
-	
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-public:    
-	virtual void Tick(float DeltaTime) override;
-	const TArray<FVector>& GetFloorTileLocations() const { return FloorTileLocations; }
-	TArray<FVector> FloorTileLocations;
-	
+
+private:
+	void ClearFood();
+
+	/** Hands the door actors of the previous level back to DoorPool. */
+	void ReleaseDoors();
+
+	/** Starts preparing Index on a worker unless it is already being prepared. */
+	void PreloadLevel(int32 Index);
+
+	/** The preloaded level if it is Index (waiting for it if needed), otherwise prepared here. */
+	TSharedPtr<FSnakePreparedLevel> TakePreparedLevel(int32 Index);
+
+	/** Game thread part of a level load: instances, doors and the simulation grid. */
+	void ApplyPreparedLevel(const FSnakePreparedLevel& Prepared);
+
+	UE::Tasks::TTask<TSharedPtr<FSnakePreparedLevel>> PreloadTask;
+	int32 PreloadIndex = INDEX_NONE;
+
+	// Levels already parsed this session. They are never modified after Prepare, so a restart
+	// or a revisit re-applies them without touching the disk
+	TMap<int32, TSharedPtr<FSnakePreparedLevel>> LevelCache;
+
+	// LevelIndex when play began, where ResetToStartLevel goes back to
+	int32 StartLevelIndex = INDEX_NONE;
+
+	// Food and doors are recycled rather than destroyed, levels only move them around
+	UPROPERTY(Transient)
+	FSnakeActorPool FoodPool;
+
+	UPROPERTY(Transient)
+	FSnakeActorPool DoorPool;
+
+	FSnakeSimulation Simulation;
 };